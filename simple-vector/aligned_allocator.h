@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+// Аллокатор, выравнивающий начало буфера по Alignment байт. Размер блока округляется вверх
+// до кратного Alignment, поэтому выровненное чтение целого регистра по последним элементам
+// не выходит за пределы выделенной памяти.
+template <typename Type, size_t Alignment>
+class AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(Type), "Alignment must not be weaker than the type's own alignment");
+
+public:
+    using value_type = Type;
+    static constexpr size_t kAlignment = Alignment;
+
+    template <typename Other>
+    struct rebind {
+        using other = AlignedAllocator<Other, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment>&) noexcept {}
+
+    Type* allocate(size_t count) {
+        if (count > (std::numeric_limits<size_t>::max() - Alignment) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<Type*>(::operator new(PaddedBytes(count), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept {
+        ::operator delete(ptr, PaddedBytes(count), std::align_val_t{Alignment});
+    }
+
+    static constexpr size_t PaddedBytes(size_t count) noexcept {
+        return (count * sizeof(Type) + Alignment - 1) / Alignment * Alignment;
+    }
+};
+
+template <typename Type, typename Other, size_t Alignment>
+bool operator==(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&) noexcept {
+    return true;
+}
+
+template <typename Type, typename Other, size_t Alignment>
+bool operator!=(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&) noexcept {
+    return false;
+}
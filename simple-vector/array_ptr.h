@@ -2,68 +2,342 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
-template <typename Type>
+#include "constexpr_support.h"
+
+namespace array_ptr_detail {
+
+// Deleter буфера, принятого извне. Лежит в куче вместе с ёмкостью буфера: ArrayPtr хранит
+// указатель на него в поле ёмкости, чтобы не увеличивать размер вектора
+struct ExternalDeleter {
+    explicit ExternalDeleter(size_t capacity) noexcept : capacity(capacity) {}
+    virtual ~ExternalDeleter() = default;
+    virtual void Delete(void* raw_ptr) noexcept = 0;
+
+    size_t capacity;
+};
+
+template <typename Type, typename Deleter>
+struct ExternalDeleterImpl final : ExternalDeleter {
+    ExternalDeleterImpl(Deleter deleter, size_t capacity) : ExternalDeleter(capacity), deleter(std::move(deleter)) {}
+
+    void Delete(void* raw_ptr) noexcept override {
+        deleter(static_cast<Type*>(raw_ptr));
+    }
+
+    Deleter deleter;
+};
+
+}  // namespace array_ptr_detail
+
+// Аллокатор может дополнительно определить
+//     Type* reallocate(Type* ptr, size_t old_count, size_t new_count) noexcept;
+// — перенести блок в блок нового размера вместе с его байтами, не копируя их (например,
+// через mremap). При неудаче возвращается nullptr, и блок ptr остаётся прежним.
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+                                    std::declval<typename std::allocator_traits<Allocator>::pointer>(),
+                                    size_t{}, size_t{}))>> : std::true_type {};
+
+// Владеет неинициализированной памятью под capacity объектов Type, полученной от Allocator.
+// Конструированием и разрушением элементов занимается владелец (SimpleVector).
+// Перемещение и обмен следуют propagate_on_container_* аллокатора: если аллокатор
+// не распространяется, аллокаторы обеих сторон обязаны быть равны.
+// Буфер, принятый извне вместе с deleter, освобождается вызовом deleter(raw_ptr).
+template <typename Type, typename Allocator = std::allocator<Type>>
 class ArrayPtr {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>,
+                  "Allocator::value_type must be the same as Type");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>,
+                  "ArrayPtr supports only allocators with raw pointers");
+
 public:
-    ArrayPtr() = default;
+    using AllocatorType = Allocator;
 
-    explicit ArrayPtr(size_t size) {
-        if (size == 0) {
-            raw_ptr_ = nullptr;
-        } else {
-            raw_ptr_ = new Type[size];
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(const Allocator& alloc) noexcept : storage_(alloc) {}
+
+    SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(size_t capacity, const Allocator& alloc = Allocator()) : storage_(alloc) {
+        if (capacity != 0) {
+            storage_.raw_ptr = AllocTraits::allocate(storage_, capacity);
+            storage_.capacity = capacity;
         }
     }
 
-    explicit ArrayPtr(Type* raw_ptr) noexcept : raw_ptr_{raw_ptr} {}
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(Type* raw_ptr, size_t capacity, const Allocator& alloc = Allocator()) noexcept : storage_(alloc) {
+        storage_.raw_ptr = raw_ptr;
+        storage_.capacity = capacity;
+    }
 
-    explicit ArrayPtr(ArrayPtr&& other) noexcept : raw_ptr_(std::exchange(other.raw_ptr_, nullptr)) {}
+    // Принимает чужой буфер. Если выделить память под deleter не удалось, буфер остаётся
+    // во владении вызывающего
+    template <typename Deleter>
+    ArrayPtr(Type* raw_ptr, size_t capacity, Deleter deleter, const Allocator& alloc) : storage_(alloc) {
+        if (raw_ptr != nullptr) {
+            auto* external = new array_ptr_detail::ExternalDeleterImpl<Type, Deleter>(std::move(deleter), capacity);
+            storage_.raw_ptr = raw_ptr;
+            storage_.capacity = EncodeExternal(external);
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr(ArrayPtr&& other) noexcept : storage_(std::move(other.GetAllocator())) {
+        storage_.raw_ptr = std::exchange(other.storage_.raw_ptr, nullptr);
+        storage_.capacity = std::exchange(other.storage_.capacity, 0);
+    }
 
-    ArrayPtr& operator=(ArrayPtr&& other) noexcept {
-        if (this != &other)
-            raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+    SIMPLE_VECTOR_CONSTEXPR ArrayPtr& operator=(ArrayPtr&& other) noexcept {
+        if (this != &other) {
+            Deallocate();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                GetAllocator() = std::move(other.GetAllocator());
+            } else {
+                assert(GetAllocator() == other.GetAllocator());
+            }
+            storage_.raw_ptr = std::exchange(other.storage_.raw_ptr, nullptr);
+            storage_.capacity = std::exchange(other.storage_.capacity, 0);
+        }
         return *this;
     }
 
     ArrayPtr(const ArrayPtr&) = delete;
 
-    ~ArrayPtr() {
-        delete[] raw_ptr_;
+    SIMPLE_VECTOR_CONSTEXPR ~ArrayPtr() {
+        Deallocate();
     }
 
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
-    [[nodiscard]] Type* Release() noexcept {
-        auto delete_array = raw_ptr_;
-        raw_ptr_ = nullptr;
-        return delete_array;
+    // Отдаёт буфер вызывающему. Принятый извне буфер освобождается его прежним способом
+    [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR Type* Release() noexcept {
+        if (IsExternal()) {
+            delete GetExternal();
+        }
+        storage_.capacity = 0;
+        return std::exchange(storage_.raw_ptr, nullptr);
     }
 
-    Type& operator[](size_t index) noexcept {
-        return *(raw_ptr_ + index);
+    // Меняет размер блока средствами аллокатора (см. HasReallocate); байты переезжают вместе
+    // с блоком. false, если аллокатор этого не умеет или отказал: тогда блок прежний
+    bool TryReallocate(size_t new_capacity) noexcept {
+        if constexpr (HasReallocate<Allocator>::value) {
+            if (storage_.raw_ptr != nullptr && !IsExternal() && new_capacity != 0) {
+                if (Type* moved = storage_.reallocate(storage_.raw_ptr, storage_.capacity, new_capacity)) {
+                    storage_.raw_ptr = moved;
+                    storage_.capacity = new_capacity;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
+        return *(storage_.raw_ptr + index);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
+        return *(storage_.raw_ptr + index);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR explicit operator bool() const {
+        return storage_.raw_ptr;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type* Get() const noexcept {
+        return storage_.raw_ptr;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+        if (IsExternal()) {
+            return GetExternal()->capacity;
+        }
+        return storage_.capacity;
     }
 
-    const Type& operator[](size_t index) const noexcept {
-        return *(raw_ptr_ + index);
+    // Буфер принят извне и освобождается не аллокатором
+    SIMPLE_VECTOR_CONSTEXPR bool IsExternal() const noexcept {
+        return (storage_.capacity & kExternalFlag) != 0;
     }
 
-    explicit operator bool() const {
-        return raw_ptr_;
+    SIMPLE_VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return storage_;
     }
 
-    Type* Get() const noexcept {
-        return raw_ptr_;
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return storage_;
     }
 
-    void swap(ArrayPtr& other) noexcept {
-        auto temp = raw_ptr_;
-        raw_ptr_ = other.raw_ptr_;
-        other.raw_ptr_ = temp;
+    SIMPLE_VECTOR_CONSTEXPR void swap(ArrayPtr& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(GetAllocator(), other.GetAllocator());
+        } else {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+        std::swap(storage_.raw_ptr, other.storage_.raw_ptr);
+        std::swap(storage_.capacity, other.storage_.capacity);
     }
 
 private:
-    Type* raw_ptr_ = nullptr;
-};
\ No newline at end of file
+    // Ни один аллокатор не выделит больше SIZE_MAX / 2 байт, так что старший бит ёмкости свободен.
+    // У принятого извне буфера в остальных битах лежит указатель на его deleter, сдвинутый
+    // на бит вправо: из-за выравнивания младший бит указателя всегда нулевой
+    static constexpr size_t kExternalFlag = ~(std::numeric_limits<size_t>::max() >> 1);
+
+    static_assert(sizeof(uintptr_t) <= sizeof(size_t) && alignof(array_ptr_detail::ExternalDeleter) > 1);
+
+    static size_t EncodeExternal(array_ptr_detail::ExternalDeleter* deleter) noexcept {
+        return kExternalFlag | static_cast<size_t>(reinterpret_cast<uintptr_t>(deleter) >> 1);
+    }
+
+    array_ptr_detail::ExternalDeleter* GetExternal() const noexcept {
+        return reinterpret_cast<array_ptr_detail::ExternalDeleter*>(static_cast<uintptr_t>(storage_.capacity) << 1);
+    }
+
+    // Наследование от аллокатора позволяет не тратить память на аллокаторы без состояния
+    struct Storage : Allocator {
+        SIMPLE_VECTOR_CONSTEXPR Storage() = default;
+        SIMPLE_VECTOR_CONSTEXPR explicit Storage(const Allocator& alloc) noexcept : Allocator(alloc) {}
+        SIMPLE_VECTOR_CONSTEXPR explicit Storage(Allocator&& alloc) noexcept : Allocator(std::move(alloc)) {}
+
+        Type* raw_ptr = nullptr;
+        size_t capacity = 0;
+    };
+
+    Storage storage_;
+
+    SIMPLE_VECTOR_CONSTEXPR void Deallocate() noexcept {
+        if (IsExternal()) {
+            array_ptr_detail::ExternalDeleter* deleter = GetExternal();
+            deleter->Delete(storage_.raw_ptr);
+            delete deleter;
+        } else if (storage_.raw_ptr != nullptr) {
+            AllocTraits::deallocate(storage_, storage_.raw_ptr, storage_.capacity);
+        }
+    }
+};
+
+// Алгоритмы над неинициализированной памятью, конструирующие и разрушающие объекты
+// через allocator_traits. При исключении уже созданные объекты разрушаются.
+
+template <typename Allocator>
+inline constexpr bool kIsStdAllocator =
+    std::is_same_v<Allocator, std::allocator<typename std::allocator_traits<Allocator>::value_type>>;
+
+// Алгоритмы std::uninitialized_* не constexpr: при вычислении на этапе компиляции объекты
+// создаются по одному через аллокатор
+template <typename Allocator>
+constexpr bool UseStdUninitialized() noexcept {
+    return kIsStdAllocator<Allocator> && !IsConstantEvaluated();
+}
+
+template <typename Allocator, typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR void ConstructAt(Allocator& alloc, Type* ptr, Args&&... args) {
+    std::allocator_traits<Allocator>::construct(alloc, ptr, std::forward<Args>(args)...);
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void DestroyAt(Allocator& alloc, Type* ptr) noexcept {
+    std::allocator_traits<Allocator>::destroy(alloc, ptr);
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void DestroyN(Allocator& alloc, Type* first, size_t count) noexcept {
+    if constexpr (kIsStdAllocator<Allocator>) {
+        std::destroy_n(first, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            DestroyAt(alloc, first + i);
+        }
+    }
+}
+
+// construct(ptr, i) создаёт i-й объект по адресу ptr
+template <typename Allocator, typename Type, typename Construct>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedConstructN(Allocator& alloc, Type* dest, size_t count, Construct construct) {
+    size_t constructed = 0;
+    try {
+        for (; constructed < count; ++constructed) {
+            construct(dest + constructed, constructed);
+        }
+    } catch (...) {
+        DestroyN(alloc, dest, constructed);
+        throw;
+    }
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedValueConstructN(Allocator& alloc, Type* dest, size_t count) {
+    if (UseStdUninitialized<Allocator>()) {
+        std::uninitialized_value_construct_n(dest, count);
+    } else {
+        UninitializedConstructN(alloc, dest, count, [&alloc](Type* ptr, size_t) {
+            ConstructAt(alloc, ptr);
+        });
+    }
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedFillN(Allocator& alloc, Type* dest, size_t count, const Type& value) {
+    if (UseStdUninitialized<Allocator>()) {
+        std::uninitialized_fill_n(dest, count, value);
+    } else {
+        UninitializedConstructN(alloc, dest, count, [&alloc, &value](Type* ptr, size_t) {
+            ConstructAt(alloc, ptr, value);
+        });
+    }
+}
+
+template <typename Allocator, typename InputIt, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type* UninitializedCopy(Allocator& alloc, InputIt first, InputIt last, Type* dest) {
+    if (UseStdUninitialized<Allocator>()) {
+        return std::uninitialized_copy(first, last, dest);
+    } else {
+        Type* current = dest;
+        try {
+            for (; first != last; ++first, ++current) {
+                ConstructAt(alloc, current, *first);
+            }
+        } catch (...) {
+            DestroyN(alloc, dest, current - dest);
+            throw;
+        }
+        return current;
+    }
+}
+
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedMoveN(Allocator& alloc, Type* src, size_t count, Type* dest) {
+    if (UseStdUninitialized<Allocator>()) {
+        std::uninitialized_move_n(src, count, dest);
+    } else {
+        UninitializedConstructN(alloc, dest, count, [&alloc, src](Type* ptr, size_t i) {
+            ConstructAt(alloc, ptr, std::move(src[i]));
+        });
+    }
+}
+
+// Перенос при реаллокации с семантикой std::move_if_noexcept: элементы с бросающим перемещением
+// копируются, чтобы при исключении исходный буфер остался нетронутым. Некопируемые типы
+// перемещаются в любом случае
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedMoveIfNoexceptN(Allocator& alloc, Type* src, size_t count, Type* dest) {
+    if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+        UninitializedMoveN(alloc, src, count, dest);
+    } else {
+        UninitializedCopy(alloc, static_cast<const Type*>(src), static_cast<const Type*>(src) + count, dest);
+    }
+}
@@ -0,0 +1,264 @@
+// Сравнение SimpleVector и std::vector на Google Benchmark.
+// Сборка и запуск с выводом в JSON:
+//     g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -o benchmark -lbenchmark -lpthread
+//     ./benchmark --benchmark_format=json --benchmark_out=bench.json --benchmark_out_format=json
+
+#include "simple_vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+class MoveOnly {
+public:
+    MoveOnly() = default;
+    explicit MoveOnly(size_t value)
+        : value_(value) {
+    }
+    MoveOnly(const MoveOnly&) = delete;
+    MoveOnly& operator=(const MoveOnly&) = delete;
+    MoveOnly(MoveOnly&& other) noexcept
+        : value_(exchange(other.value_, 0)) {
+    }
+    MoveOnly& operator=(MoveOnly&& other) noexcept {
+        value_ = exchange(other.value_, 0);
+        return *this;
+    }
+    size_t GetValue() const {
+        return value_;
+    }
+
+private:
+    size_t value_ = 0;
+};
+
+template <typename Type>
+Type MakeValue(size_t i) {
+    if constexpr (is_same_v<Type, string>) {
+        // Длиннее SSO-буфера, чтобы строки владели памятью в куче
+        return "benchmark value number "s + to_string(i);
+    } else {
+        return Type(i);
+    }
+}
+
+// Единый интерфейс к SimpleVector и std::vector
+template <typename Container>
+struct Ops;
+
+template <typename Type>
+struct Ops<SimpleVector<Type>> {
+    static void PushBack(SimpleVector<Type>& v, Type&& value) {
+        v.PushBack(std::move(value));
+    }
+    static void Insert(SimpleVector<Type>& v, size_t index, Type&& value) {
+        v.Insert(v.begin() + index, std::move(value));
+    }
+    static void Erase(SimpleVector<Type>& v, size_t index) {
+        v.Erase(v.begin() + index);
+    }
+    static void Reserve(SimpleVector<Type>& v, size_t capacity) {
+        v.Reserve(capacity);
+    }
+    static void Resize(SimpleVector<Type>& v, size_t size) {
+        v.Resize(size);
+    }
+    static size_t Size(const SimpleVector<Type>& v) {
+        return v.GetSize();
+    }
+};
+
+template <typename Type>
+struct Ops<vector<Type>> {
+    static void PushBack(vector<Type>& v, Type&& value) {
+        v.push_back(std::move(value));
+    }
+    static void Insert(vector<Type>& v, size_t index, Type&& value) {
+        v.insert(v.begin() + index, std::move(value));
+    }
+    static void Erase(vector<Type>& v, size_t index) {
+        v.erase(v.begin() + index);
+    }
+    static void Reserve(vector<Type>& v, size_t capacity) {
+        v.reserve(capacity);
+    }
+    static void Resize(vector<Type>& v, size_t size) {
+        v.resize(size);
+    }
+    static size_t Size(const vector<Type>& v) {
+        return v.size();
+    }
+};
+
+template <typename Container>
+Container MakeFilled(size_t size) {
+    using Type = typename iterator_traits<decltype(declval<Container&>().begin())>::value_type;
+    Container v;
+    Ops<Container>::Reserve(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        Ops<Container>::PushBack(v, MakeValue<Type>(i));
+    }
+    return v;
+}
+
+template <typename Container, typename Type>
+void BM_PushBack(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Container v;
+        for (size_t i = 0; i < size; ++i) {
+            Ops<Container>::PushBack(v, MakeValue<Type>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, typename Type>
+void BM_PushBackReserved(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Container v;
+        Ops<Container>::Reserve(v, size);
+        for (size_t i = 0; i < size; ++i) {
+            Ops<Container>::PushBack(v, MakeValue<Type>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum class Where { kFront, kMiddle, kBack };
+
+template <typename Container, typename Type, Where where>
+void BM_Insert(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Container v;
+        for (size_t i = 0; i < size; ++i) {
+            size_t current = Ops<Container>::Size(v);
+            size_t index = where == Where::kFront ? 0 : where == Where::kMiddle ? current / 2 : current;
+            Ops<Container>::Insert(v, index, MakeValue<Type>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, typename Type>
+void BM_EraseFront(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container v = MakeFilled<Container>(size);
+        state.ResumeTiming();
+        while (Ops<Container>::Size(v) != 0) {
+            Ops<Container>::Erase(v, 0);
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, typename Type>
+void BM_Resize(benchmark::State& state) {
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        Container v;
+        for (size_t step = 1; step <= size; step *= 2) {
+            Ops<Container>::Resize(v, step);
+        }
+        Ops<Container>::Resize(v, size / 2);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, typename Type>
+void BM_Copy(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container source = MakeFilled<Container>(size);
+    for (auto _ : state) {
+        Container copy(source);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, typename Type>
+void BM_Move(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Container source = MakeFilled<Container>(size);
+    for (auto _ : state) {
+        Container moved(std::move(source));
+        benchmark::DoNotOptimize(moved.begin());
+        source = std::move(moved);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container, typename Type>
+void BM_Iterate(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container v = MakeFilled<Container>(size);
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const Type& value : v) {
+            if constexpr (is_same_v<Type, string>) {
+                sum += value.size();
+            } else if constexpr (is_same_v<Type, MoveOnly>) {
+                sum += value.GetValue();
+            } else {
+                sum += static_cast<size_t>(value);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+constexpr int64_t kMinSize = 1 << 6;
+constexpr int64_t kMaxSize = 1 << 16;
+// Вставка и удаление в начале квадратичны, для них размеры меньше
+constexpr int64_t kMaxShiftSize = 1 << 13;
+
+#define SV_BENCHMARK_FOR_TYPE(Type)                                                                           \
+    BENCHMARK_TEMPLATE(BM_PushBack, SimpleVector<Type>, Type)->Range(kMinSize, kMaxSize);                      \
+    BENCHMARK_TEMPLATE(BM_PushBack, vector<Type>, Type)->Range(kMinSize, kMaxSize);                            \
+    BENCHMARK_TEMPLATE(BM_PushBackReserved, SimpleVector<Type>, Type)->Range(kMinSize, kMaxSize);              \
+    BENCHMARK_TEMPLATE(BM_PushBackReserved, vector<Type>, Type)->Range(kMinSize, kMaxSize);                    \
+    BENCHMARK_TEMPLATE(BM_Insert, SimpleVector<Type>, Type, Where::kFront)->Range(kMinSize, kMaxShiftSize);    \
+    BENCHMARK_TEMPLATE(BM_Insert, vector<Type>, Type, Where::kFront)->Range(kMinSize, kMaxShiftSize);          \
+    BENCHMARK_TEMPLATE(BM_Insert, SimpleVector<Type>, Type, Where::kMiddle)->Range(kMinSize, kMaxShiftSize);   \
+    BENCHMARK_TEMPLATE(BM_Insert, vector<Type>, Type, Where::kMiddle)->Range(kMinSize, kMaxShiftSize);         \
+    BENCHMARK_TEMPLATE(BM_Insert, SimpleVector<Type>, Type, Where::kBack)->Range(kMinSize, kMaxSize);          \
+    BENCHMARK_TEMPLATE(BM_Insert, vector<Type>, Type, Where::kBack)->Range(kMinSize, kMaxSize);                \
+    BENCHMARK_TEMPLATE(BM_EraseFront, SimpleVector<Type>, Type)->Range(kMinSize, kMaxShiftSize);               \
+    BENCHMARK_TEMPLATE(BM_EraseFront, vector<Type>, Type)->Range(kMinSize, kMaxShiftSize);                     \
+    BENCHMARK_TEMPLATE(BM_Resize, SimpleVector<Type>, Type)->Range(kMinSize, kMaxSize);                        \
+    BENCHMARK_TEMPLATE(BM_Resize, vector<Type>, Type)->Range(kMinSize, kMaxSize);                              \
+    BENCHMARK_TEMPLATE(BM_Move, SimpleVector<Type>, Type)->Range(kMinSize, kMaxSize);                          \
+    BENCHMARK_TEMPLATE(BM_Move, vector<Type>, Type)->Range(kMinSize, kMaxSize);                                \
+    BENCHMARK_TEMPLATE(BM_Iterate, SimpleVector<Type>, Type)->Range(kMinSize, kMaxSize);                       \
+    BENCHMARK_TEMPLATE(BM_Iterate, vector<Type>, Type)->Range(kMinSize, kMaxSize)
+
+SV_BENCHMARK_FOR_TYPE(int);
+SV_BENCHMARK_FOR_TYPE(string);
+SV_BENCHMARK_FOR_TYPE(MoveOnly);
+
+// Копирование есть только у копируемых типов
+BENCHMARK_TEMPLATE(BM_Copy, SimpleVector<int>, int)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_Copy, vector<int>, int)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_Copy, SimpleVector<string>, string)->Range(kMinSize, kMaxSize);
+BENCHMARK_TEMPLATE(BM_Copy, vector<string>, string)->Range(kMinSize, kMaxSize);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+// Вектор из блоков по ChunkSize элементов. Рост добавляет новый блок и никогда не переносит
+// элементы, поэтому ссылки на элементы стабильны, а PushBack не требует памяти сверх одного
+// блока и не делает массового перемещения. Реаллоцируется только таблица указателей на блоки,
+// которая меньше данных в ChunkSize раз. Освободившиеся после PopBack блоки сохраняются
+// до ShrinkToFit или Clear. Итераторы хранят указатель на таблицу и, в отличие от ссылок,
+// становятся недействительными при добавлении блока.
+template <typename Type, size_t ChunkSize = std::max<size_t>(1, (size_t{1} << 16) / sizeof(Type))>
+class ChunkedSimpleVector {
+    static_assert(ChunkSize != 0, "ChunkSize must be positive");
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    static constexpr size_t kChunkSize = ChunkSize;
+
+    ChunkedSimpleVector() noexcept = default;
+
+    // Конструкторы делегируют конструктору по умолчанию: если элемент бросит исключение,
+    // объект уже создан, и деструктор освободит блоки и созданные элементы
+    explicit ChunkedSimpleVector(size_t size) : ChunkedSimpleVector() {
+        Resize(size);
+    }
+
+    ChunkedSimpleVector(size_t size, const Type& value) : ChunkedSimpleVector() {
+        Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(value);
+        }
+    }
+
+    ChunkedSimpleVector(std::initializer_list<Type> init) : ChunkedSimpleVector() {
+        Reserve(init.size());
+        for (const Type& value : init) {
+            PushBack(value);
+        }
+    }
+
+    ChunkedSimpleVector(const ChunkedSimpleVector& other) : ChunkedSimpleVector() {
+        Reserve(other.size_);
+        for (const Type& value : other) {
+            PushBack(value);
+        }
+    }
+
+    ChunkedSimpleVector(ChunkedSimpleVector&& other) noexcept
+        : chunks_(std::move(other.chunks_)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    ChunkedSimpleVector& operator=(const ChunkedSimpleVector& rhs) {
+        if (this != &rhs) {
+            ChunkedSimpleVector copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    ChunkedSimpleVector& operator=(ChunkedSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            ChunkedSimpleVector moved(std::move(rhs));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~ChunkedSimpleVector() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return chunks_.GetSize() * ChunkSize;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return chunks_[index / ChunkSize][index % ChunkSize];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return chunks_[index / ChunkSize][index % ChunkSize];
+    }
+
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(chunks_.begin(), 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(chunks_.begin(), size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(chunks_.begin(), 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(chunks_.begin(), size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Элемент конструируется сразу на месте: существующие элементы не двигаются, так что
+    // аргументы могут ссылаться на элементы этого же вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            AddChunk();
+        }
+        Type* slot = chunks_[size_ / ChunkSize] + size_ % ChunkSize;
+        ConstructAt(alloc_, slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyAt(alloc_, chunks_[size_ / ChunkSize] + size_ % ChunkSize);
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    // Заранее выделяет блоки под new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        size_t chunk_count = new_capacity / ChunkSize + (new_capacity % ChunkSize != 0);
+        chunks_.Reserve(chunk_count);
+        while (chunks_.GetSize() < chunk_count) {
+            AddChunk();
+        }
+    }
+
+    // Освобождает блоки, в которых нет элементов
+    void ShrinkToFit() noexcept {
+        size_t used_chunks = size_ / ChunkSize + (size_ % ChunkSize != 0);
+        while (chunks_.GetSize() > used_chunks) {
+            std::allocator_traits<std::allocator<Type>>::deallocate(alloc_, chunks_[chunks_.GetSize() - 1], ChunkSize);
+            chunks_.PopBack();
+        }
+    }
+
+    void Clear() noexcept {
+        while (size_ != 0) {
+            PopBack();
+        }
+        ShrinkToFit();
+    }
+
+    void swap(ChunkedSimpleVector& other) noexcept {
+        chunks_.swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    std::allocator<Type> alloc_;
+    SimpleVector<Type*> chunks_;
+    size_t size_ = 0;
+
+    void AddChunk() {
+        // Место в таблице резервируется до выделения блока, чтобы блок не потерялся
+        if (chunks_.GetSize() == chunks_.GetCapacity()) {
+            chunks_.Reserve(std::max<size_t>(1, chunks_.GetSize() * 2));
+        }
+        chunks_.PushBack(std::allocator_traits<std::allocator<Type>>::allocate(alloc_, ChunkSize));
+    }
+
+    template <bool IsConst>
+    class BasicIterator {
+        using ChunkPointer = std::conditional_t<IsConst, Type* const*, Type**>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const Type*, Type*>;
+        using reference = std::conditional_t<IsConst, const Type&, Type&>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(ChunkPointer chunks, size_t index) noexcept : chunks_(chunks), index_(index) {}
+
+        // Неконстантный итератор неявно приводится к константному
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+            : chunks_(other.chunks_), index_(other.index_) {}
+
+        reference operator*() const noexcept {
+            return chunks_[index_ / ChunkSize][index_ % ChunkSize];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return !(lhs < rhs);
+        }
+
+    private:
+        template <bool>
+        friend class BasicIterator;
+
+        ChunkPointer chunks_ = nullptr;
+        size_t index_ = 0;
+    };
+};
+
+template <typename Type, size_t ChunkSize>
+bool operator==(const ChunkedSimpleVector<Type, ChunkSize>& lhs, const ChunkedSimpleVector<Type, ChunkSize>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type, size_t ChunkSize>
+bool operator!=(const ChunkedSimpleVector<Type, ChunkSize>& lhs, const ChunkedSimpleVector<Type, ChunkSize>& rhs) {
+    return !(lhs == rhs);
+}
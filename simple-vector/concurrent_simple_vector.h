@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор только для добавления, в который можно писать из многих потоков без блокировок.
+// Элементы лежат в сегментах геометрически растущего размера: сегмент k вмещает
+// FirstSegmentSize << k элементов, его адрес публикуется один раз, и при росте уже
+// записанные элементы никуда не переезжают — ссылки и индексы стабильны.
+//
+// PushBack/EmplaceBack lock-free и возвращают индекс элемента. Элемент становится виден
+// читателям, когда опубликованы все элементы перед ним: GetSize() возвращает эту границу,
+// а operator[] для индексов меньше неё wait-free. Вектор не копируется и не перемещается;
+// разрушать его можно, только когда добавления завершены.
+template <typename Type, size_t FirstSegmentSize = 32>
+class ConcurrentSimpleVector {
+    static_assert(FirstSegmentSize != 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0,
+                  "FirstSegmentSize must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<Type>,
+                  "ConcurrentSimpleVector requires a nothrow move constructible type");
+
+public:
+    ConcurrentSimpleVector() noexcept = default;
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ~ConcurrentSimpleVector() {
+        const size_t size = published_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; ++i) {
+            Slot(i)->~Type();
+        }
+        for (std::atomic<Segment*>& segment : segments_) {
+            if (Segment* raw = segment.load(std::memory_order_relaxed)) {
+                ::operator delete(raw, std::align_val_t{kSegmentAlignment});
+            }
+        }
+    }
+
+    size_t PushBack(const Type& value) {
+        return EmplaceBack(value);
+    }
+
+    size_t PushBack(Type&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Индекс резервируется только после того, как сегмент под него выделен, а конструирование
+    // на месте не бросает исключений, поэтому в векторе не бывает пропусков: исключение из
+    // конструктора или аллокации оставляет вектор нетронутым
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<Type, Args&&...>) {
+            size_t index = ReserveIndex();
+            new (Slot(index)) Type(std::forward<Args>(args)...);
+            Publish(index);
+            return index;
+        } else {
+            Type value(std::forward<Args>(args)...);
+            size_t index = ReserveIndex();
+            new (Slot(index)) Type(std::move(value));
+            Publish(index);
+            return index;
+        }
+    }
+
+    // Заранее выделяет сегменты под capacity элементов
+    void Reserve(size_t capacity) {
+        for (size_t index = 0; index < capacity;) {
+            auto [segment, offset] = Locate(index);
+            AcquireSegment(segment);
+            index += SegmentSize(segment) - offset;
+        }
+    }
+
+    // Число опубликованных элементов: все элементы с меньшими индексами доступны для чтения
+    size_t GetSize() const noexcept {
+        return published_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return *Slot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return *Slot(index);
+    }
+
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *Slot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *Slot(index);
+    }
+
+private:
+    static constexpr size_t kFirstSegmentShift = __builtin_ctzll(FirstSegmentSize);
+    static constexpr size_t kSegmentCount = sizeof(size_t) * 8 - kFirstSegmentShift;
+    static constexpr size_t kSegmentAlignment = alignof(Type);
+
+    // Сегмент: SegmentSize(k) ячеек под элементы, за ними столько же флагов готовности
+    struct Segment;
+
+    std::atomic<Segment*> segments_[kSegmentCount] = {};
+    // Число зарезервированных индексов
+    std::atomic<size_t> reserved_{0};
+    // Граница, до которой все элементы сконструированы
+    std::atomic<size_t> published_{0};
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    struct Location {
+        size_t segment;
+        size_t offset;
+    };
+
+    // Индексы [F * (2^k - 1), F * (2^(k+1) - 1)) лежат в сегменте k
+    static Location Locate(size_t index) noexcept {
+        size_t shifted = index + FirstSegmentSize;
+        size_t high_bit = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(shifted);
+        return {high_bit - kFirstSegmentShift, shifted - (size_t{1} << high_bit)};
+    }
+
+    static Type* Slots(Segment* segment) noexcept {
+        return reinterpret_cast<Type*>(segment);
+    }
+
+    static std::atomic<bool>* ReadyFlags(Segment* segment, size_t segment_index) noexcept {
+        return reinterpret_cast<std::atomic<bool>*>(Slots(segment) + SegmentSize(segment_index));
+    }
+
+    Type* Slot(size_t index) const noexcept {
+        auto [segment, offset] = Locate(index);
+        return Slots(segments_[segment].load(std::memory_order_acquire)) + offset;
+    }
+
+    std::atomic<bool>& ReadyFlag(size_t index) const noexcept {
+        auto [segment, offset] = Locate(index);
+        return ReadyFlags(segments_[segment].load(std::memory_order_acquire), segment)[offset];
+    }
+
+    // Возвращает сегмент, выделяя его при необходимости. Из нескольких потоков, выделивших
+    // сегмент одновременно, публикует свой только один, остальные освобождают память
+    Segment* AcquireSegment(size_t segment_index) {
+        std::atomic<Segment*>& slot = segments_[segment_index];
+        Segment* segment = slot.load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            return segment;
+        }
+        const size_t count = SegmentSize(segment_index);
+        if (count > (std::numeric_limits<size_t>::max() - count) / sizeof(Type)) {
+            throw std::length_error("ConcurrentSimpleVector is too large");
+        }
+        auto* fresh = static_cast<Segment*>(
+            ::operator new(count * sizeof(Type) + count * sizeof(std::atomic<bool>), std::align_val_t{kSegmentAlignment}));
+        std::atomic<bool>* flags = ReadyFlags(fresh, segment_index);
+        for (size_t i = 0; i < count; ++i) {
+            new (flags + i) std::atomic<bool>(false);
+        }
+        if (slot.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        ::operator delete(fresh, std::align_val_t{kSegmentAlignment});
+        return segment;
+    }
+
+    // Успешный обмен — release: поток, прочитавший новое значение reserved_ (Publish), видит
+    // и сегмент, выделенный или полученный до резервирования индекса
+    size_t ReserveIndex() {
+        size_t index = reserved_.load(std::memory_order_relaxed);
+        do {
+            AcquireSegment(Locate(index).segment);
+        } while (!reserved_.compare_exchange_weak(index, index + 1, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return index;
+    }
+
+    // Отмечает элемент готовым и продвигает границу публикации через все готовые подряд
+    // элементы, помогая потокам, которые закончили раньше, но ждали предшественников
+    void Publish(size_t index) noexcept {
+        ReadyFlag(index).store(true, std::memory_order_seq_cst);
+        size_t published = published_.load(std::memory_order_seq_cst);
+        // Загрузка reserved_ не слабее acquire: после неё сегмент индекса published виден
+        while (published < reserved_.load(std::memory_order_seq_cst) &&
+               ReadyFlag(published).load(std::memory_order_seq_cst)) {
+            // При неудаче published получает текущее значение, и проверка повторяется с него
+            if (published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) {
+                ++published;
+            }
+        }
+    }
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+// В C++20 память, выделенная std::allocator при вычислении константного выражения, доступна
+// constexpr-коду, если освобождается там же. Тогда SimpleVector и ArrayPtr помечаются constexpr
+// и таблицы можно строить при компиляции; в C++17 макрос пустой и код не меняется.
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc) && \
+    defined(__cpp_lib_is_constant_evaluated) && defined(__cpp_consteval)
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 1
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#else
+#define SIMPLE_VECTOR_CONSTEXPR
+#endif
+
+// В C++20 constexpr-конструктор может оставить тривиальные члены неинициализированными.
+// Тогда встроенные массивы не обнуляются при создании вектора во время выполнения
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201907L && defined(__cpp_lib_is_constant_evaluated)
+#define SIMPLE_VECTOR_HAS_CONSTEXPR_TRIVIAL_INIT 1
+#endif
+
+// Истинно при вычислении на этапе компиляции: тогда memcpy, memmove, SIMD и статистика
+// недоступны, и код идёт обычными поэлементными путями
+constexpr bool IsConstantEvaluated() noexcept {
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Вектор с разделяемым буфером и копированием при записи. Копия стоит O(1): она лишь
+// увеличивает атомарный счётчик ссылок на общий SimpleVector. Первый изменяющий вызов
+// (неконстантные operator[], At, begin/end, PushBack, Insert, Erase, Resize и т. д.)
+// у разделяемого вектора сначала клонирует данные.
+//
+// Вызовы, отдающие изменяемые ссылки или итераторы (GetMutable, неконстантные operator[], At,
+// begin/end, EmplaceBack, Insert, Erase), помечают буфер неразделяемым: иначе следующая копия
+// разделила бы его, и запись через старую ссылку изменила бы снимок. Копия такого вектора
+// клонирует данные; разделять буфер снова можно после Clear() или AllowSharing().
+//
+// Гарантии потокобезопасности как у std::shared_ptr: разные объекты, разделяющие буфер,
+// можно читать и менять из разных потоков; один объект из нескольких потоков — только читать.
+// Чтобы обойти вектор, не клонируя его, обращайтесь к нему через const-ссылку.
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class CowSimpleVector {
+public:
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+    using Iterator = typename Vector::Iterator;
+    using ConstIterator = typename Vector::ConstIterator;
+
+    CowSimpleVector() noexcept = default;
+
+    explicit CowSimpleVector(size_t size) : CowSimpleVector(Vector(size)) {}
+
+    CowSimpleVector(size_t size, const Type& value) : CowSimpleVector(Vector(size, value)) {}
+
+    CowSimpleVector(std::initializer_list<Type> init) : CowSimpleVector(Vector(init)) {}
+
+    // Забирает содержимое обычного вектора без копирования элементов
+    explicit CowSimpleVector(Vector&& vector) : shared_(CreateShared(std::move(vector))) {}
+
+    CowSimpleVector(const CowSimpleVector& other) : shared_(other.shared_) {
+        if (shared_ == nullptr) {
+            return;
+        }
+        if (!shared_->shareable) {
+            shared_ = CreateShared(Vector(other.shared_->vector));
+        } else {
+            shared_->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowSimpleVector(CowSimpleVector&& other) noexcept : shared_(std::exchange(other.shared_, nullptr)) {}
+
+    CowSimpleVector& operator=(const CowSimpleVector& rhs) {
+        CowSimpleVector(rhs).swap(*this);
+        return *this;
+    }
+
+    CowSimpleVector& operator=(CowSimpleVector&& rhs) noexcept {
+        CowSimpleVector(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~CowSimpleVector() {
+        Unshare();
+    }
+
+    // Доступ на чтение не клонирует буфер
+
+    const Vector& Get() const noexcept {
+        return shared_ != nullptr ? shared_->vector : EmptyVector();
+    }
+
+    size_t GetSize() const noexcept {
+        return Get().GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return Get().GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return Get().IsEmpty();
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return Get()[index];
+    }
+
+    const Type& At(size_t index) const {
+        return Get().At(index);
+    }
+
+    ConstIterator begin() const noexcept {
+        return Get().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return Get().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Get().cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Get().cend();
+    }
+
+    // Число объектов, разделяющих буфер (0 у пустого вектора без буфера)
+    size_t GetUseCount() const noexcept {
+        return shared_ != nullptr ? shared_->references.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool IsShared() const noexcept {
+        return shared_ != nullptr && shared_->references.load(std::memory_order_acquire) > 1;
+    }
+
+    // Изменяющий доступ: буфер клонируется, если он разделяется с другими объектами
+
+    Vector& GetMutable() {
+        Vector& vector = MakeUnique();
+        shared_->shareable = false;
+        return vector;
+    }
+
+    // Разрешает следующим копиям разделять буфер. Вызывайте, когда ссылки и итераторы,
+    // полученные через изменяющий доступ, больше не используются для записи
+    void AllowSharing() noexcept {
+        if (shared_ != nullptr) {
+            shared_->shareable = true;
+        }
+    }
+
+    Type& operator[](size_t index) {
+        return GetMutable()[index];
+    }
+
+    Type& At(size_t index) {
+        return GetMutable().At(index);
+    }
+
+    Iterator begin() {
+        return GetMutable().begin();
+    }
+
+    Iterator end() {
+        return GetMutable().end();
+    }
+
+    void PushBack(const Type& item) {
+        MakeUnique().PushBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        MakeUnique().PushBack(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return GetMutable().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Позиции задаются итераторами любого из объектов, разделяющих буфер: они пересчитываются
+    // в индексы до клонирования
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        size_t offset = pos - cbegin();
+        Vector& vector = GetMutable();
+        return vector.Insert(vector.cbegin() + offset, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        size_t offset = pos - cbegin();
+        Vector& vector = GetMutable();
+        return vector.Insert(vector.cbegin() + offset, std::move(value));
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        size_t offset = pos - cbegin();
+        Vector& vector = GetMutable();
+        return vector.Erase(vector.cbegin() + offset);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        size_t offset = first - cbegin();
+        size_t count = last - first;
+        Vector& vector = GetMutable();
+        return vector.Erase(vector.cbegin() + offset, vector.cbegin() + offset + count);
+    }
+
+    void PopBack() {
+        MakeUnique().PopBack();
+    }
+
+    void Resize(size_t new_size) {
+        MakeUnique().Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        MakeUnique().Reserve(new_capacity);
+    }
+
+    // Разделяемый буфер просто отпускается, без клонирования. Выданные ссылки на элементы
+    // больше недействительны, поэтому буфер снова можно разделять
+    void Clear() noexcept {
+        if (shared_ != nullptr && shared_->references.load(std::memory_order_acquire) == 1) {
+            shared_->vector.Clear();
+            shared_->shareable = true;
+        } else {
+            Unshare();
+        }
+    }
+
+    void swap(CowSimpleVector& other) noexcept {
+        std::swap(shared_, other.shared_);
+    }
+
+private:
+    struct Shared {
+        explicit Shared(Vector&& vector) noexcept : vector(std::move(vector)) {}
+
+        std::atomic<size_t> references{1};
+        // Неразделяемый буфер всегда принадлежит одному объекту, поэтому флаг не атомарный
+        bool shareable = true;
+        Vector vector;
+    };
+
+    using SharedAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Shared>;
+    using SharedTraits = std::allocator_traits<SharedAllocator>;
+
+    Shared* shared_ = nullptr;
+
+    static const Vector& EmptyVector() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    static Shared* CreateShared(Vector&& vector) {
+        SharedAllocator alloc(vector.GetAllocator());
+        Shared* shared = SharedTraits::allocate(alloc, 1);
+        new (shared) Shared(std::move(vector));
+        return shared;
+    }
+
+    // Клонирует буфер, если он разделяется, не меняя флаг shareable
+    Vector& MakeUnique() {
+        if (shared_ == nullptr) {
+            shared_ = CreateShared(Vector());
+        } else if (shared_->references.load(std::memory_order_acquire) > 1) {
+            Shared* clone = CreateShared(Vector(shared_->vector));
+            Unshare();
+            shared_ = clone;
+        }
+        return shared_->vector;
+    }
+
+    // Отпускает ссылку; последний владелец разрушает буфер
+    void Unshare() noexcept {
+        Shared* shared = std::exchange(shared_, nullptr);
+        if (shared != nullptr && shared->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            SharedAllocator alloc(shared->vector.GetAllocator());
+            shared->~Shared();
+            SharedTraits::deallocate(alloc, shared, 1);
+        }
+    }
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    // Разделяющие буфер векторы равны без поэлементного сравнения
+    return (lhs.begin() == rhs.begin() && lhs.GetSize() == rhs.GetSize()) || lhs.Get() == rhs.Get();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
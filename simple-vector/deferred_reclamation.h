@@ -0,0 +1,286 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "simple_vector.h"
+
+// Отложенное освобождение больших буферов. Разрушение многогигабайтного вектора — это обход
+// всех элементов и возврат памяти системе (munmap), которые на рабочем потоке выливаются
+// в паузы в десятки миллисекунд. BufferReclaimer принимает такие буферы и освобождает их
+// пачками в своём фоновом потоке; передающий поток тратит на передачу одно небольшое
+// выделение памяти и одну атомарную операцию.
+//
+// Есть два способа воспользоваться им:
+//  * DeferredAllocator — аллокатор, который отдаёт фоновому потоку блоки от порогового размера.
+//    Так откладывается освобождение памяти при разрушении, присваивании и реаллокации;
+//  * RetireAsync(std::move(vector)) — вектор целиком переезжает в фоновый поток, где
+//    разрушаются и его элементы.
+
+namespace reclamation_detail {
+
+struct Retired {
+    virtual ~Retired() = default;
+
+    Retired* next = nullptr;
+    size_t bytes = 0;
+};
+
+// Освобождение — это разрушение узла
+template <typename Object>
+struct RetiredObject final : Retired {
+    explicit RetiredObject(Object&& object) : object(std::move(object)) {}
+
+    Object object;
+};
+
+template <typename Allocator>
+struct RetiredBlock final : Retired {
+    using Traits = std::allocator_traits<Allocator>;
+
+    RetiredBlock(const Allocator& alloc, typename Traits::pointer ptr, size_t count) noexcept
+        : alloc(alloc),
+          ptr(ptr),
+          count(count) {}
+
+    ~RetiredBlock() override {
+        Traits::deallocate(alloc, ptr, count);
+    }
+
+    Allocator alloc;
+    typename Traits::pointer ptr;
+    size_t count;
+};
+
+}  // namespace reclamation_detail
+
+class BufferReclaimer {
+public:
+    BufferReclaimer() : worker_([this] {
+        Run();
+    }) {}
+
+    BufferReclaimer(const BufferReclaimer&) = delete;
+    BufferReclaimer& operator=(const BufferReclaimer&) = delete;
+
+    // Дожидается освобождения всего переданного
+    ~BufferReclaimer() {
+        {
+            std::lock_guard guard(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+
+    // Забирает object и разрушает его в фоновом потоке; bytes — сколько памяти он освободит
+    // (только для статистики). Из самого фонового потока объект разрушается сразу
+    template <typename Object>
+    void Retire(Object&& object, size_t bytes) {
+        using Node = reclamation_detail::RetiredObject<std::remove_reference_t<Object>>;
+        static_assert(!std::is_lvalue_reference_v<Object>, "Retire takes ownership: pass an rvalue");
+        if (IsWorkerThread()) {
+            [[maybe_unused]] std::remove_reference_t<Object> dropped(std::move(object));
+            return;
+        }
+        Push(new Node(std::move(object)), bytes);
+    }
+
+    // Освобождает блок alloc.deallocate(ptr, count) в фоновом потоке. Если не удалось выделить
+    // узел очереди или вызов пришёл из фонового потока, блок освобождается сразу
+    template <typename Allocator>
+    void RetireBlock(const Allocator& alloc, typename std::allocator_traits<Allocator>::pointer ptr,
+                     size_t count) noexcept {
+        using Node = reclamation_detail::RetiredBlock<Allocator>;
+        Node* node = IsWorkerThread() ? nullptr : new (std::nothrow) Node(alloc, ptr, count);
+        if (node == nullptr) {
+            Allocator copy(alloc);
+            std::allocator_traits<Allocator>::deallocate(copy, ptr, count);
+            return;
+        }
+        Push(node, count * sizeof(typename std::allocator_traits<Allocator>::value_type));
+    }
+
+    // Ждёт, пока освободится всё, что было передано до вызова
+    void Flush() {
+        const uint64_t target = retired_.load(std::memory_order_acquire);
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&] {
+            return reclaimed_ >= target;
+        });
+    }
+
+    // Байты, переданные, но ещё не освобождённые
+    size_t GetPendingBytes() const noexcept {
+        return pending_bytes_.load(std::memory_order_relaxed);
+    }
+
+    // Байты, освобождённые фоновым потоком за всё время
+    uint64_t GetReclaimedBytes() const noexcept {
+        return reclaimed_bytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    using Retired = reclamation_detail::Retired;
+
+    // Стек переданных узлов: передающие потоки добавляют в него без блокировок, фоновый
+    // поток забирает его целиком одной операцией
+    std::atomic<Retired*> head_{nullptr};
+    std::atomic<uint64_t> retired_{0};
+    std::atomic<size_t> pending_bytes_{0};
+    std::atomic<uint64_t> reclaimed_bytes_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t reclaimed_ = 0;
+    bool stop_ = false;
+
+    std::thread worker_;
+
+    bool IsWorkerThread() const noexcept {
+        return std::this_thread::get_id() == worker_.get_id();
+    }
+
+    void Push(Retired* node, size_t bytes) noexcept {
+        node->bytes = bytes;
+        pending_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        retired_.fetch_add(1, std::memory_order_release);
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        // Будить нужно, только если стек был пуст: иначе фоновый поток ещё не забрал прежние
+        // узлы и увидит новый вместе с ними. Захват мьютекса исключает потерю пробуждения
+        if (node->next == nullptr) {
+            std::lock_guard guard(mutex_);
+            wake_.notify_one();
+        }
+    }
+
+    void Run() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] {
+                return stop_ || head_.load(std::memory_order_relaxed) != nullptr;
+            });
+            Retired* batch = head_.exchange(nullptr, std::memory_order_acquire);
+            if (batch == nullptr) {
+                return;
+            }
+            lock.unlock();
+            uint64_t count = 0;
+            size_t bytes = 0;
+            while (batch != nullptr) {
+                Retired* next = batch->next;
+                bytes += batch->bytes;
+                delete batch;
+                batch = next;
+                ++count;
+            }
+            pending_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+            reclaimed_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            lock.lock();
+            reclaimed_ += count;
+            done_.notify_all();
+        }
+    }
+};
+
+// Общий фоновый поток; создаётся при первом обращении
+inline BufferReclaimer& GetBufferReclaimer() {
+    static BufferReclaimer reclaimer;
+    return reclaimer;
+}
+
+inline constexpr size_t kDefaultDeferThreshold = size_t{1} << 20;
+
+// Аллокатор поверх Base, который освобождает блоки от threshold_bytes байт в фоновом потоке
+// reclaimer, а меньшие — сразу. Выделяет память Base. Когда освобождение выполняет сам фоновый
+// поток (например, разрушая вектор, переданный через RetireAsync), блок освобождается сразу.
+template <typename Type, typename Base = std::allocator<Type>>
+class DeferredAllocator {
+    using BaseTraits = std::allocator_traits<Base>;
+
+    static_assert(std::is_same_v<typename BaseTraits::value_type, Type>, "Base::value_type must be Type");
+
+public:
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template <typename Other>
+    struct rebind {
+        using other = DeferredAllocator<Other, typename BaseTraits::template rebind_alloc<Other>>;
+    };
+
+    DeferredAllocator() : reclaimer_(&GetBufferReclaimer()) {}
+
+    explicit DeferredAllocator(BufferReclaimer& reclaimer, size_t threshold_bytes = kDefaultDeferThreshold,
+                               const Base& base = Base()) noexcept
+        : base_(base),
+          reclaimer_(&reclaimer),
+          threshold_bytes_(threshold_bytes) {}
+
+    template <typename Other, typename OtherBase>
+    DeferredAllocator(const DeferredAllocator<Other, OtherBase>& other) noexcept
+        : base_(other.base_),
+          reclaimer_(other.reclaimer_),
+          threshold_bytes_(other.threshold_bytes_) {}
+
+    Type* allocate(size_t count) {
+        return BaseTraits::allocate(base_, count);
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept {
+        if (count >= threshold_bytes_ / sizeof(Type)) {
+            reclaimer_->RetireBlock(base_, ptr, count);
+        } else {
+            BaseTraits::deallocate(base_, ptr, count);
+        }
+    }
+
+    BufferReclaimer& GetReclaimer() const noexcept {
+        return *reclaimer_;
+    }
+
+    size_t GetThresholdBytes() const noexcept {
+        return threshold_bytes_;
+    }
+
+    template <typename Other, typename OtherBase>
+    bool operator==(const DeferredAllocator<Other, OtherBase>& other) const noexcept {
+        return base_ == other.base_ && reclaimer_ == other.reclaimer_;
+    }
+
+    template <typename Other, typename OtherBase>
+    bool operator!=(const DeferredAllocator<Other, OtherBase>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    template <typename, typename>
+    friend class DeferredAllocator;
+
+    Base base_;
+    BufferReclaimer* reclaimer_;
+    size_t threshold_bytes_ = kDefaultDeferThreshold;
+};
+
+// Отдаёт вектор фоновому потоку вместе с элементами: вызывающий возвращается сразу, а
+// разрушение элементов и освобождение памяти происходят в reclaimer
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void RetireAsync(SimpleVector<Type, Allocator, GrowthPolicy>&& vector,
+                 BufferReclaimer& reclaimer = GetBufferReclaimer()) {
+    const size_t bytes = vector.GetCapacity() * sizeof(Type);
+    reclaimer.Retire(std::move(vector), bytes);
+}
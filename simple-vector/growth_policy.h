@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+// Политика роста решает, какой ёмкости выделить новый буфер, когда в текущий
+// не помещается required элементов. Политика — класс со статическим методом
+//     static size_t NextCapacity(size_t capacity, size_t required, size_t element_size);
+// возвращающим значение не меньше required.
+
+namespace growth_detail {
+
+// capacity * numerator / denominator без переполнения: при переполнении возвращает максимум size_t
+template <size_t Numerator, size_t Denominator>
+constexpr size_t ScaleSaturating(size_t capacity) noexcept {
+    constexpr size_t kMax = std::numeric_limits<size_t>::max();
+    size_t whole = capacity / Denominator;
+    size_t rest = capacity % Denominator;
+    if (whole > kMax / Numerator) {
+        return kMax;
+    }
+    size_t scaled = whole * Numerator;
+    size_t rest_scaled = rest * Numerator / Denominator;
+    return scaled > kMax - rest_scaled ? kMax : scaled + rest_scaled;
+}
+
+}  // namespace growth_detail
+
+// Рост в Numerator / Denominator раз
+template <size_t Numerator, size_t Denominator = 1>
+struct FactorGrowth {
+    static_assert(Numerator > Denominator, "Growth factor must be greater than 1");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(required, growth_detail::ScaleSaturating<Numerator, Denominator>(capacity));
+    }
+};
+
+using DoublingGrowth = FactorGrowth<2>;
+
+// Множитель меньше золотого сечения позволяет аллокатору со временем переиспользовать
+// освобождённые при предыдущих ростах блоки
+using HalfGrowth = FactorGrowth<3, 2>;
+
+// Округляет ёмкость, выбранную BasePolicy, вверх до размерного класса аллокатора, чтобы
+// использовать память, которую аллокатор всё равно отдаст. Классы устроены как в
+// jemalloc/tcmalloc: четыре класса на каждую степень двойки, не меньше MinBlock байт;
+// блоки от PageSize байт округляются до целых страниц.
+template <typename BasePolicy = DoublingGrowth, size_t PageSize = 4096, size_t MinBlock = 16>
+struct SizeClassGrowth {
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+    static constexpr size_t RoundToSizeClass(size_t bytes) noexcept {
+        if (bytes <= MinBlock) {
+            return MinBlock;
+        }
+        size_t step = PageSize;
+        if (bytes < PageSize) {
+            size_t power = MinBlock;
+            while (power * 2 < bytes) {
+                power *= 2;
+            }
+            // bytes лежит в (power, 2 * power]: шаг классов — четверть нижней степени двойки
+            step = std::max<size_t>(power / 4, MinBlock);
+        }
+        size_t rounded = (bytes + step - 1) / step * step;
+        return rounded < bytes ? bytes : rounded;
+    }
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        size_t base = BasePolicy::NextCapacity(capacity, required, element_size);
+        if (base > std::numeric_limits<size_t>::max() / element_size) {
+            return base;
+        }
+        return std::max(base, RoundToSizeClass(base * element_size) / element_size);
+    }
+};
+
+// Политика может также определить
+//     static size_t RoundCapacity(size_t capacity, size_t element_size);
+// Тогда явно заданная ёмкость (конструкторы, Reserve, Assign, ShrinkTo) округляется этим
+// методом, а не выделяется точно.
+template <typename Policy, typename = void>
+struct HasRoundPolicy : std::false_type {};
+
+template <typename Policy>
+struct HasRoundPolicy<Policy, std::void_t<decltype(Policy::RoundCapacity(size_t{}, size_t{}))>> : std::true_type {};
+
+// Округляет ёмкость вверх до целого числа векторных регистров шириной Bytes, и при росте
+// по BasePolicy, и при явно заданной ёмкости. Если Bytes не кратно размеру элемента,
+// ёмкость не меняется.
+template <typename BasePolicy = DoublingGrowth, size_t Bytes = 64>
+struct PaddedGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        return RoundCapacity(BasePolicy::NextCapacity(capacity, required, element_size), element_size);
+    }
+
+    static constexpr size_t RoundCapacity(size_t capacity, size_t element_size) noexcept {
+        if (Bytes % element_size != 0) {
+            return capacity;
+        }
+        size_t lanes = Bytes / element_size;
+        if (capacity > std::numeric_limits<size_t>::max() - lanes) {
+            return capacity;
+        }
+        return (capacity + lanes - 1) / lanes * lanes;
+    }
+};
+
+// Политика может дополнительно определить
+//     static size_t ShrinkCapacity(size_t capacity, size_t size, size_t element_size);
+// Тогда вектор после удаления элементов сам уменьшает ёмкость до возвращённого значения,
+// если оно меньше текущей ёмкости.
+template <typename Policy, typename = void>
+struct HasShrinkPolicy : std::false_type {};
+
+template <typename Policy>
+struct HasShrinkPolicy<Policy,
+                       std::void_t<decltype(Policy::ShrinkCapacity(size_t{}, size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Рост по BasePolicy и автоматическое сжатие с гистерезисом: буфер ужимается вдвое больше
+// размера, когда заполнен не более чем на 1 / ShrinkDivisor. Короткие колебания размера
+// не приводят к чередованию роста и сжатия. Буферы до MinCapacity элементов не сжимаются,
+// в том числе опустевшие: иначе PushBack/PopBack около нуля выделяли бы память на каждом
+// цикле. Освободить буфер целиком можно явным ShrinkToFit.
+template <typename BasePolicy = DoublingGrowth, size_t ShrinkDivisor = 4, size_t MinCapacity = 16>
+struct AutoShrinkGrowth {
+    static_assert(ShrinkDivisor > 2, "Shrink threshold must leave room for hysteresis");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        return BasePolicy::NextCapacity(capacity, required, element_size);
+    }
+
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size, size_t /*element_size*/) noexcept {
+        if (capacity <= MinCapacity || size > capacity / ShrinkDivisor) {
+            return capacity;
+        }
+        return std::max(size * 2, MinCapacity);
+    }
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include "parallel.h"
+
+enum class NumaPlacement {
+    kDefault,     // страница попадает на узел потока, первым коснувшегося её
+    kBind,        // только узлы из маски
+    kInterleave,  // страницы по очереди на узлы из маски
+};
+
+struct LargePageOptions {
+    // Блоки от этого размера отображаются через mmap, меньшие выделяются обычным operator new
+    size_t threshold_bytes = size_t{64} << 20;
+    // Сначала пробовать огромные страницы из зарезервированного в системе пула (MAP_HUGETLB).
+    // Если пул исчерпан, блок отображается обычными страницами
+    bool explicit_huge_pages = false;
+    // Просить ядро собирать блок из прозрачных огромных страниц (madvise MADV_HUGEPAGE)
+    bool transparent_huge_pages = true;
+    NumaPlacement numa_placement = NumaPlacement::kDefault;
+    // Узлы для kBind и kInterleave: бит i — узел i
+    uint64_t numa_nodes = 0;
+    // Касаться страниц нового блока кусками в нескольких потоках, деля блок так же, как
+    // ParallelFor с first_touch_policy. При kDefault куски страниц окажутся на узлах тех потоков,
+    // которые потом параллельно заполняют те же куски
+    bool parallel_first_touch = false;
+    ParallelPolicy first_touch_policy;
+};
+
+// Аллокатор для очень больших буферов (Linux). Блоки от threshold_bytes отображаются анонимным
+// mmap, выровненным по огромной странице и кратным ей: меньше промахов TLB, а размещение по узлам
+// NUMA задаётся mbind. Рост такого блока идёт через mremap, который переносит страницы, а не
+// копирует байты; SimpleVector пользуется этим для побайтно переносимых типов (HasReallocate).
+// На других системах огромные страницы, NUMA и mremap недоступны, и блоки просто отображаются.
+template <typename Type>
+class LargePageAllocator {
+public:
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+    LargePageAllocator() noexcept = default;
+
+    explicit LargePageAllocator(const LargePageOptions& options) noexcept : options_(options) {}
+
+    template <typename Other>
+    LargePageAllocator(const LargePageAllocator<Other>& other) noexcept : options_(other.GetOptions()) {}
+
+    // Ошибки mbind (кроме ядра без NUMA) выбрасываются как std::system_error
+    Type* allocate(size_t count) {
+        if (count > (std::numeric_limits<size_t>::max() - kHugePageSize) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        if (!IsLargeBlock(count)) {
+            return std::allocator<Type>().allocate(count);
+        }
+        const size_t length = MappedLength(count);
+        void* ptr = MapBlock(length);
+        try {
+            Place(ptr, length);
+        } catch (...) {
+            ::munmap(ptr, length);
+            throw;
+        }
+        TouchPages(ptr, 0, count);
+        return static_cast<Type*>(ptr);
+    }
+
+    void deallocate(Type* ptr, size_t count) noexcept {
+        if (IsLargeBlock(count)) {
+            ::munmap(ptr, MappedLength(count));
+        } else {
+            std::allocator<Type>().deallocate(ptr, count);
+        }
+    }
+
+    // Меняет размер отображённого блока через mremap; nullptr, если старый или новый блок
+    // меньше порога или ядро отказало
+    Type* reallocate(Type* ptr, size_t old_count, size_t new_count) noexcept {
+#ifdef __linux__
+        if (!IsLargeBlock(old_count) || !IsLargeBlock(new_count) ||
+            new_count > (std::numeric_limits<size_t>::max() - kHugePageSize) / sizeof(Type)) {
+            return nullptr;
+        }
+        const size_t old_length = MappedLength(old_count);
+        const size_t new_length = MappedLength(new_count);
+        void* moved = old_length == new_length ? ptr : ::mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            return nullptr;
+        }
+        if (new_length > old_length) {
+            // Политика NUMA и MADV_HUGEPAGE наследуются расширенным отображением, но новый
+            // хвост всё равно стоит разметить: размещение — только подсказка, ошибки не важны
+            char* tail = static_cast<char*>(moved) + old_length;
+            AdviseHugePages(tail, new_length - old_length);
+            try {
+                Place(tail, new_length - old_length);
+            } catch (...) {
+            }
+            TouchPages(moved, old_count, new_count);
+        }
+        return static_cast<Type*>(moved);
+#else
+        (void)ptr;
+        (void)old_count;
+        (void)new_count;
+        return nullptr;
+#endif
+    }
+
+    // Блок на count элементов отображается через mmap
+    bool IsLargeBlock(size_t count) const noexcept {
+        return count != 0 && count >= (options_.threshold_bytes + sizeof(Type) - 1) / sizeof(Type);
+    }
+
+    const LargePageOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    // Блок, выделенный одним аллокатором, освобождает другой, если оба одинаково выбирают
+    // между mmap и operator new
+    template <typename Other>
+    bool operator==(const LargePageAllocator<Other>& other) const noexcept {
+        return options_.threshold_bytes == other.GetOptions().threshold_bytes;
+    }
+
+    template <typename Other>
+    bool operator!=(const LargePageAllocator<Other>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    LargePageOptions options_;
+
+    static size_t MappedLength(size_t count) noexcept {
+        return (count * sizeof(Type) + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    void* MapBlock(size_t length) const {
+#ifdef MAP_HUGETLB
+        if (options_.explicit_huge_pages) {
+            void* ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                               -1, 0);
+            if (ptr != MAP_FAILED) {
+                return ptr;
+            }
+        }
+#endif
+        // Отображаем с запасом в огромную страницу и обрезаем края: прозрачные огромные
+        // страницы собираются только из выровненных участков
+        void* raw = ::mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                           0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(raw);
+        const size_t head = (kHugePageSize - address % kHugePageSize) % kHugePageSize;
+        if (head != 0) {
+            ::munmap(raw, head);
+        }
+        ::munmap(static_cast<char*>(raw) + head + length, kHugePageSize - head);
+        void* ptr = static_cast<char*>(raw) + head;
+        AdviseHugePages(ptr, length);
+        return ptr;
+    }
+
+    void AdviseHugePages([[maybe_unused]] void* ptr, [[maybe_unused]] size_t length) const noexcept {
+#ifdef MADV_HUGEPAGE
+        // Если прозрачные огромные страницы выключены в системе, блок остаётся на обычных
+        if (options_.transparent_huge_pages) {
+            ::madvise(ptr, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // mbind вызывается напрямую, чтобы не зависеть от libnuma
+    void Place([[maybe_unused]] void* ptr, [[maybe_unused]] size_t length) const {
+#ifdef __linux__
+        if (options_.numa_placement == NumaPlacement::kDefault) {
+            return;
+        }
+        const unsigned long mask = static_cast<unsigned long>(options_.numa_nodes);
+        const int mode = options_.numa_placement == NumaPlacement::kBind ? MPOL_BIND : MPOL_INTERLEAVE;
+        if (::syscall(SYS_mbind, ptr, length, mode, &mask, sizeof(mask) * 8 + 1, 0) != 0 && errno != ENOSYS) {
+            throw std::system_error(errno, std::system_category(), "mbind");
+        }
+#endif
+    }
+
+    // Пишет ноль в первый байт каждой страницы элементов [first, last) блока ptr. Куски
+    // совпадают с кусками ParallelFor по тем же элементам; страница достаётся куску,
+    // в котором лежит её начало, поэтому каждой страницы касается один поток
+    void TouchPages(void* ptr, size_t first, size_t last) const noexcept {
+        if (!options_.parallel_first_touch) {
+            return;
+        }
+        const uintptr_t page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const uintptr_t base = reinterpret_cast<uintptr_t>(ptr);
+        auto touch = [&](size_t chunk_first, size_t chunk_last) {
+            const uintptr_t begin = base + (first + chunk_first) * sizeof(Type);
+            const uintptr_t end = base + (first + chunk_last) * sizeof(Type);
+            for (uintptr_t page = (begin + page_size - 1) / page_size * page_size; page < end; page += page_size) {
+                *reinterpret_cast<volatile char*>(page) = 0;
+            }
+        };
+        try {
+            ParallelFor(options_.first_touch_policy, static_cast<Type*>(ptr) + first, last - first, sizeof(Type),
+                        touch, [](size_t, size_t) {});
+        } catch (...) {
+            // Касание — только подсказка размещения: без него страницы появятся при заполнении
+        }
+    }
+};
@@ -1,9 +1,40 @@
+#define SIMPLE_VECTOR_STATS
+#define SIMPLE_VECTOR_DEBUG_VIEWS
 #include "simple_vector.h"
+#include "small_simple_vector.h"
+#include "mapped_simple_vector.h"
+#include "serialization.h"
+#include "cow_simple_vector.h"
+#include "concurrent_simple_vector.h"
+#include "chunked_simple_vector.h"
+#include "static_simple_vector.h"
+#include "soa_simple_vector.h"
+#include "deferred_reclamation.h"
+#include "simple_vector_pool.h"
+#include "large_page_allocator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <new>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
 
 using namespace std;
 
@@ -150,6 +181,1743 @@ void TestNoncopiableErase() {
     cout << "Done!"s << endl << endl;
 }
 
+class NoDefault {
+public:
+    explicit NoDefault(int value)
+        : value_(value) {
+        ++alive;
+    }
+    NoDefault(const NoDefault& other)
+        : value_(other.value_) {
+        ++alive;
+    }
+    NoDefault& operator=(const NoDefault& other) = default;
+    ~NoDefault() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    inline static int alive = 0;
+
+private:
+    int value_;
+};
+
+void TestUninitializedStorage() {
+    cout << "Test uninitialized storage"s << endl;
+    {
+        SimpleVector<NoDefault> v(Reserve(100));
+        assert(v.GetCapacity() == 100);
+        assert(NoDefault::alive == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(NoDefault(i));
+        }
+        assert(NoDefault::alive == 10);
+
+        v.Insert(v.begin() + 5, NoDefault(42));
+        assert(v[5].GetValue() == 42 && v[6].GetValue() == 5);
+        assert(NoDefault::alive == 11);
+
+        v.Erase(v.begin());
+        v.PopBack();
+        assert(v.GetSize() == 9 && NoDefault::alive == 9);
+
+        while (v.GetSize() > 3) {
+            v.PopBack();
+        }
+        assert(NoDefault::alive == 3);
+
+        SimpleVector<NoDefault> copy(v);
+        assert(NoDefault::alive == 6);
+        copy.Clear();
+        assert(NoDefault::alive == 3);
+    }
+    assert(NoDefault::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+struct Record {
+    Record(int id, string name)
+        : id(id), name(std::move(name)) {
+    }
+    Record(Record&& other) noexcept
+        : id(other.id), name(std::move(other.name)) {
+        ++moves;
+    }
+    Record& operator=(Record&& other) noexcept {
+        id = other.id;
+        name = std::move(other.name);
+        ++moves;
+        return *this;
+    }
+
+    int id;
+    string name;
+
+    inline static int moves = 0;
+};
+
+void TestEmplace() {
+    cout << "Test emplace"s << endl;
+    SimpleVector<Record> v(Reserve(4));
+
+    Record& first = v.EmplaceBack(1, "one"s);
+    assert(&first == &v[0] && first.id == 1 && first.name == "one"s);
+    v.EmplaceBack(3, "three"s);
+    assert(Record::moves == 0);
+
+    auto it = v.Emplace(v.begin() + 1, 2, "two"s);
+    assert(it == v.begin() + 1 && it->id == 2 && it->name == "two"s);
+    assert(v[2].id == 3 && v.GetSize() == 3);
+
+    // в конец без перемещений
+    Record::moves = 0;
+    it = v.Emplace(v.end(), 4, "four"s);
+    assert(Record::moves == 0 && it->id == 4);
+
+    // с реаллокацией: элемент создаётся сразу в новом буфере
+    it = v.Emplace(v.begin(), 0, "zero"s);
+    assert(Record::moves == 4);
+    for (size_t i = 0; i < v.GetSize(); ++i) {
+        assert(v[i].id == static_cast<int>(i));
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+struct Handle {
+    explicit Handle(int value)
+        : ptr(make_unique<int>(value)) {
+    }
+    unique_ptr<int> ptr;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
+void TestTriviallyRelocatable() {
+    cout << "Test trivially relocatable"s << endl;
+    static_assert(kIsTriviallyRelocatable<int>);
+    static_assert(!kIsTriviallyRelocatable<string>);
+
+    SimpleVector<Handle> v;
+    for (int i = 0; i < 10; ++i) {
+        v.EmplaceBack(i);
+    }
+    // в начало с реаллокацией и в середину без неё
+    v.Emplace(v.begin(), -1);
+    v.Emplace(v.begin() + 5, 100);
+    v.Erase(v.begin() + 1);
+    assert(v.GetSize() == 11);
+    assert(*v[0].ptr == -1 && *v[4].ptr == 100 && *v[5].ptr == 4 && *v[10].ptr == 9);
+
+    SimpleVector<int> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.Insert(numbers.begin() + numbers.GetSize() / 2, i);
+    }
+    numbers.Erase(numbers.begin());
+    assert(numbers.GetSize() == 999);
+    assert(numbers[0] == 3 && numbers[498] == 999 && numbers[998] == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+template <typename Type>
+struct CountingAllocator {
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit CountingAllocator(int id = 0)
+        : id(id) {
+    }
+    template <typename Other>
+    CountingAllocator(const CountingAllocator<Other>& other)
+        : id(other.id) {
+    }
+
+    Type* allocate(size_t n) {
+        ++allocations;
+        return std::allocator<Type>().allocate(n);
+    }
+    void deallocate(Type* ptr, size_t n) {
+        ++deallocations;
+        std::allocator<Type>().deallocate(ptr, n);
+    }
+
+    bool operator==(const CountingAllocator& other) const {
+        return id == other.id;
+    }
+    bool operator!=(const CountingAllocator& other) const {
+        return id != other.id;
+    }
+
+    int id;
+    inline static int allocations = 0;
+    inline static int deallocations = 0;
+};
+
+void TestAllocator() {
+    cout << "Test allocator"s << endl;
+    using Alloc = CountingAllocator<string>;
+    // Отладочная проверка видов добавляет к вектору счётчик поколений
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+    static_assert(sizeof(SimpleVector<int>) == 4 * sizeof(void*));
+#else
+    static_assert(sizeof(SimpleVector<int>) == 3 * sizeof(void*));
+#endif
+    {
+        SimpleVector<string, Alloc> v(Alloc(1));
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(to_string(i));
+        }
+        assert(Alloc::allocations == 4 && Alloc::deallocations == 3);
+
+        SimpleVector<string, Alloc> copy(v);
+        assert(copy.GetAllocator().id == 1 && copy == v);
+
+        SimpleVector<string, Alloc> other(3, "x"s, Alloc(2));
+        other = v;
+        assert(other.GetAllocator().id == 1 && other == v);
+
+        SimpleVector<string, Alloc> moved(Alloc(3));
+        moved = std::move(copy);
+        assert(moved.GetAllocator().id == 1 && moved == v && copy.IsEmpty());
+    }
+    assert(Alloc::allocations == Alloc::deallocations);
+
+    // аллокатор не распространяется при присваивании: элементы переносятся поштучно
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+    using PmrVector = SimpleVector<int, std::pmr::polymorphic_allocator<int>>;
+    PmrVector a(&arena);
+    for (int i = 0; i < 10; ++i) {
+        a.PushBack(i);
+    }
+    assert(a.begin() >= reinterpret_cast<int*>(buffer) && a.end() <= reinterpret_cast<int*>(buffer + sizeof(buffer)));
+    PmrVector b;
+    b = std::move(a);
+    assert(b.GetAllocator().resource() == std::pmr::get_default_resource());
+    assert(b.GetSize() == 10 && b[9] == 9);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSmallSimpleVector() {
+    cout << "Test small simple vector"s << endl;
+    // Перемещающее присваивание с неравными нераспространяемыми аллокаторами выделяет память
+    static_assert(is_nothrow_move_assignable_v<SmallSimpleVector<string, 4>>);
+    static_assert(!is_nothrow_move_assignable_v<SmallSimpleVector<int, 4, pmr::polymorphic_allocator<int>>>);
+    CountingAllocator<string>::allocations = CountingAllocator<string>::deallocations = 0;
+    {
+        SmallSimpleVector<string, 4, CountingAllocator<string>> v;
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(to_string(i));
+        }
+        v.Erase(v.begin());
+        v.Insert(v.begin(), "first"s);
+        assert(v.IsSmall() && v.GetCapacity() == 4);
+        assert(CountingAllocator<string>::allocations == 0);
+
+        auto small_copy = v;
+        assert(small_copy.IsSmall() && small_copy == v);
+
+        // переход в кучу
+        v.Insert(v.begin() + 2, "middle"s);
+        assert(!v.IsSmall() && v.GetCapacity() == 8);
+        assert(CountingAllocator<string>::allocations == 1);
+        assert(v[0] == "first"s && v[2] == "middle"s && v[4] == "3"s);
+
+        auto moved = std::move(v);
+        assert(!moved.IsSmall() && v.IsEmpty() && moved.GetSize() == 5);
+        assert(CountingAllocator<string>::allocations == 1);
+
+        small_copy.swap(moved);
+        assert(small_copy.GetSize() == 5 && moved.GetSize() == 4 && moved.IsSmall());
+        assert(moved < small_copy);
+
+        // Присваивание с другим аллокатором: старые элементы возвращаются старому аллокатору
+        SmallSimpleVector<string, 4, CountingAllocator<string>> other(CountingAllocator<string>(1));
+        for (int i = 0; i < 6; ++i) {
+            other.PushBack("other"s);
+        }
+        other = small_copy;
+        assert(other == small_copy && other.GetAllocator().id == 0);
+    }
+    assert(CountingAllocator<string>::allocations == CountingAllocator<string>::deallocations);
+
+    SmallSimpleVector<X, 2> noncopiable;
+    for (size_t i = 0; i < 5; ++i) {
+        noncopiable.EmplaceBack(i);
+    }
+    noncopiable.Resize(7);
+    assert(noncopiable[4].GetX() == 4 && noncopiable[6].GetX() == 5);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestGrowthPolicy() {
+    cout << "Test growth policy"s << endl;
+    static_assert(DoublingGrowth::NextCapacity(0, 1, 4) == 1);
+    static_assert(DoublingGrowth::NextCapacity(8, 9, 4) == 16);
+    static_assert(DoublingGrowth::NextCapacity(8, 100, 4) == 100);
+    static_assert(HalfGrowth::NextCapacity(8, 9, 4) == 12);
+    static_assert(HalfGrowth::NextCapacity(1, 2, 4) == 2);
+    static_assert(DoublingGrowth::NextCapacity(numeric_limits<size_t>::max() - 1, numeric_limits<size_t>::max(), 1)
+                  == numeric_limits<size_t>::max());
+
+    // 5 * 24 = 120 байт округляется до класса 128, 640 байт — до 640, 5000 байт — до двух страниц
+    using SizeClass = SizeClassGrowth<DoublingGrowth>;
+    static_assert(SizeClass::RoundToSizeClass(120) == 128);
+    static_assert(SizeClass::RoundToSizeClass(600) == 640);
+    static_assert(SizeClass::RoundToSizeClass(5000) == 8192);
+    static_assert(SizeClass::NextCapacity(0, 1, 24) == 1);
+    static_assert(SizeClass::NextCapacity(4, 5, 5) == 9);
+
+    SimpleVector<int, std::allocator<int>, HalfGrowth> v;
+    SimpleVector<int> doubling;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(i);
+        doubling.PushBack(i);
+    }
+    assert(v.GetCapacity() == 13 && doubling.GetCapacity() == 16);
+    v.Resize(20);
+    assert(v.GetCapacity() == 20);
+    v.Insert(v.begin(), -1);
+    assert(v.GetCapacity() == 30 && v[0] == -1 && v[10] == 9);
+
+    SimpleVector<string, std::allocator<string>, SizeClassGrowth<>> strings{"a"s, "b"s, "c"s};
+    strings.PushBack("d"s);
+    assert(strings.GetCapacity() * sizeof(string) == SizeClassGrowth<>::RoundToSizeClass(6 * sizeof(string)));
+    cout << "Done!"s << endl << endl;
+}
+
+void TestShrink() {
+    cout << "Test shrink"s << endl;
+    SimpleVector<string> v(100, "x"s);
+    v.Resize(10);
+    assert(v.GetCapacity() == 100);
+    v.ShrinkTo(50);
+    assert(v.GetCapacity() == 50 && v.GetSize() == 10 && v[9] == "x"s);
+    v.ShrinkTo(1);
+    assert(v.GetCapacity() == 10);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 10);
+    v.Clear();
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 0 && v.begin() == nullptr);
+
+    SmallSimpleVector<string, 4> small(10, "y"s);
+    small.Resize(3);
+    small.ShrinkToFit();
+    assert(small.IsSmall() && small.GetCapacity() == 4 && small[2] == "y"s);
+
+    // сжатие с гистерезисом: ёмкость уменьшается вдвое больше размера при заполнении не более 1/4
+    SimpleVector<int, std::allocator<int>, AutoShrinkGrowth<>> cache;
+    for (int i = 0; i < 128; ++i) {
+        cache.PushBack(i);
+    }
+    assert(cache.GetCapacity() == 128);
+    while (cache.GetSize() > 33) {
+        cache.PopBack();
+    }
+    assert(cache.GetCapacity() == 128);
+    cache.PopBack();
+    cache.Erase(cache.begin());
+    assert(cache.GetCapacity() == 64 && cache.GetSize() == 31 && cache[0] == 1);
+    cache.PushBack(100);
+    cache.PushBack(101);
+    assert(cache.GetCapacity() == 64);
+    cache.Resize(10);
+    assert(cache.GetCapacity() == 20);
+    // Опустевший вектор сохраняет MinCapacity, освобождает буфер только явный ShrinkToFit
+    cache.Clear();
+    assert(cache.GetCapacity() == 16);
+    cache.ShrinkToFit();
+    assert(cache.GetCapacity() == 0);
+
+    // Чередование PushBack/PopBack около нуля не выделяет память
+    using Alloc = CountingAllocator<int>;
+    SimpleVector<int, Alloc, AutoShrinkGrowth<>> queue;
+    queue.PushBack(1);
+    queue.PopBack();
+    const int allocations = Alloc::allocations;
+    for (int i = 0; i < 100; ++i) {
+        queue.PushBack(i);
+        queue.PopBack();
+    }
+    assert(Alloc::allocations == allocations && queue.GetCapacity() != 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRangeOperations() {
+    cout << "Test range operations"s << endl;
+    SimpleVector<int> numbers{1, 2, 3};
+    const int batch[] = {10, 11, 12, 13};
+    auto it = numbers.Insert(numbers.begin() + 1, begin(batch), end(batch));
+    assert(it == numbers.begin() + 1 && numbers.GetCapacity() == 7);
+    assert((numbers == SimpleVector<int>{1, 10, 11, 12, 13, 2, 3}));
+    numbers.Insert(numbers.begin(), 2, numbers[6]);
+    assert((numbers == SimpleVector<int>{3, 3, 1, 10, 11, 12, 13, 2, 3}));
+    numbers.Append(begin(batch), begin(batch) + 2);
+    assert(numbers.GetSize() == 11 && numbers[10] == 11);
+
+    SimpleVector<string> words{"a"s, "e"s};
+    const string middle[] = {"b"s, "c"s, "d"s};
+    words.Reserve(10);
+    words.Insert(words.begin() + 1, begin(middle), end(middle));
+    assert((words == SimpleVector<string>{"a"s, "b"s, "c"s, "d"s, "e"s}));
+    words.Insert(words.end() - 1, 2, words[0]);
+    assert((words == SimpleVector<string>{"a"s, "b"s, "c"s, "d"s, "a"s, "a"s, "e"s}));
+    assert(words.GetCapacity() == 10);
+
+    // однопроходные итераторы
+    istringstream input("x y z"s);
+    words.Insert(words.begin() + 1, istream_iterator<string>(input), istream_iterator<string>());
+    assert(words.GetSize() == 10 && words[1] == "x"s && words[3] == "z"s && words[4] == "b"s);
+
+    words.Assign(begin(middle), end(middle));
+    assert((words == SimpleVector<string>{"b"s, "c"s, "d"s}));
+    words.Assign(begin(middle), begin(middle) + 1);
+    assert((words == SimpleVector<string>{"b"s}));
+    SimpleVector<string> many(20, "q"s);
+    words.Assign(many.begin(), many.end());
+    assert(words == many && words.GetCapacity() == 20);
+
+    SmallSimpleVector<int, 4> small;
+    small.Append(begin(batch), end(batch));
+    small.Insert(small.begin(), 1, 0);
+    assert(!small.IsSmall() && small.GetSize() == 5 && small[0] == 0 && small[4] == 13);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestRangeErase() {
+    cout << "Test range erase"s << endl;
+    SimpleVector<int> numbers(10);
+    iota(numbers.begin(), numbers.end(), 0);
+    auto it = numbers.Erase(numbers.begin() + 2, numbers.begin() + 5);
+    assert(*it == 5 && (numbers == SimpleVector<int>{0, 1, 5, 6, 7, 8, 9}));
+    it = numbers.Erase(numbers.begin() + 3, numbers.begin() + 3);
+    assert(*it == 6 && numbers.GetSize() == 7);
+    assert(EraseIf(numbers, [](int x) { return x % 2 == 1; }) == 4);
+    assert((numbers == SimpleVector<int>{0, 6, 8}));
+    assert(Erase(numbers, 6) == 1 && Erase(numbers, 6) == 0);
+    it = numbers.Erase(numbers.begin(), numbers.end());
+    assert(numbers.IsEmpty() && it == numbers.end());
+
+    {
+        SimpleVector<NoDefault> records;
+        for (int i = 0; i < 10; ++i) {
+            records.EmplaceBack(i);
+        }
+        assert(EraseIf(records, [](const NoDefault& x) { return x.GetValue() < 7; }) == 7);
+        assert(records.GetSize() == 3 && records[0].GetValue() == 7 && NoDefault::alive == 3);
+    }
+    assert(NoDefault::alive == 0);
+
+    SmallSimpleVector<string, 4> small{"a"s, "b"s, "a"s, "c"s};
+    assert(Erase(small, "a"s) == 2 && small[0] == "b"s && small[1] == "c"s);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestStats() {
+    cout << "Test stats"s << endl;
+    // Хуки вызываются и из noexcept-методов, поэтому бросающий callback не принимается
+    static_assert(!is_convertible_v<void (*)(const VectorEvent&), VectorStatsCallback>);
+    static SimpleVector<const void*> reallocated_vectors(Reserve(16));
+    SetVectorStatsCallback([](const VectorEvent& event) noexcept {
+        if (event.kind == VectorEventKind::kReallocate) {
+            reallocated_vectors.PushBack(event.vector);
+        }
+    });
+    ResetVectorStats();
+
+    SimpleVector<int> v;
+    for (int i = 0; i < 5; ++i) {
+        v.PushBack(i);
+    }
+    VectorStatsSnapshot stats = GetVectorStats();
+    assert(stats.reallocations == 4);
+    assert(stats.bytes_allocated == (1 + 2 + 4 + 8) * sizeof(int));
+    assert(stats.elements_relocated == 0 + 1 + 2 + 4);
+    assert(reallocated_vectors.GetSize() == 4 && reallocated_vectors[3] == &v);
+
+    v.Insert(v.begin() + 1, 10);
+    v.Erase(v.begin());
+    stats = GetVectorStats();
+    assert(stats.reallocations == 4 && stats.elements_shifted == 4 + 5);
+
+    v.Resize(1);
+    assert(GetVectorStats().peak_capacity_ratio == 8.0);
+
+    // Лишняя ёмкость видна сразу после реаллокации: и после Reserve, и после удвоения
+    ResetVectorStats();
+    SimpleVector<int> reserved;
+    reserved.Reserve(1000);
+    assert(GetVectorStats().peak_capacity_ratio == 1000.0);
+    reserved.PushBack(1);
+    ResetVectorStats();
+    reserved.Resize(1000);
+    reserved.PushBack(2);
+    assert(reserved.GetCapacity() == 2000 && GetVectorStats().peak_capacity_ratio == 1.998);
+
+    SetVectorStatsCallback(nullptr);
+    ResetVectorStats();
+    assert(GetVectorStats().reallocations == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+struct ThrowingOnCreate {
+    ThrowingOnCreate() {
+        if (++created == 50000) {
+            throw runtime_error("fail"s);
+        }
+        ++alive;
+    }
+    ~ThrowingOnCreate() {
+        --alive;
+    }
+    inline static atomic<int> created = 0;
+    inline static atomic<int> alive = 0;
+};
+
+struct ThrowingOnCopy {
+    ThrowingOnCopy() = default;
+    ThrowingOnCopy(const ThrowingOnCopy&) {
+        if (--copies_left == 0) {
+            throw runtime_error("fail"s);
+        }
+    }
+    inline static int copies_left = 0;
+};
+
+void TestParallel() {
+    cout << "Test parallel"s << endl;
+    ParallelPolicy policy;
+    policy.thread_count = 4;
+    policy.min_elements_per_thread = 1000;
+
+    const size_t size = 100003;
+    SimpleVector<int> zeros(policy, size);
+    assert(zeros.GetSize() == size && all_of(zeros.begin(), zeros.end(), [](int x) { return x == 0; }));
+
+    SimpleVector<string> filled(policy, size, "value"s);
+    assert(filled.GetSize() == size && filled[0] == "value"s && filled[size - 1] == "value"s);
+
+    SimpleVector<string> copy(policy, filled);
+    assert(Equal(policy, copy, filled) && !Less(policy, copy, filled));
+    copy[size / 2] = "a"s;
+    assert(!Equal(policy, copy, filled) && Less(policy, copy, filled) && !Less(policy, filled, copy));
+    copy.PopBack();
+    assert(!Equal(policy, copy, filled));
+
+    zeros.Resize(policy, 3 * size);
+    assert(zeros.GetSize() == 3 * size && zeros[3 * size - 1] == 0);
+    zeros.Resize(policy, 10);
+    assert(zeros.GetSize() == 10);
+
+    // исключение в одном потоке: уже созданные элементы разрушаются
+    try {
+        SimpleVector<ThrowingOnCreate> failing(policy, size);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    assert(ThrowingOnCreate::alive == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSimdSearch() {
+    cout << "Test SIMD search and comparison"s << endl;
+    // Размеры некратны ширине блока, чтобы проверить и векторную часть, и хвост
+    SimpleVector<int> ints(1003);
+    iota(ints.begin(), ints.end(), 0);
+    assert(ints.Find(0) == ints.begin() && ints.Find(1002) == ints.end() - 1);
+    assert(ints.Find(517) - ints.begin() == 517 && ints.Find(-1) == ints.end());
+    ints[900] = 517;
+    assert(ints.Count(517) == 2 && ints.Contains(517) && !ints.Contains(5000));
+
+    SimpleVector<int64_t> longs(77, int64_t{1} << 40);
+    longs[70] = 1;
+    assert(longs.Count(int64_t{1} << 40) == 76 && longs.Find(1) - longs.begin() == 70);
+
+    SimpleVector<char> chars(100, 'a');
+    chars[99] = 'b';
+    assert(chars.Find('b') - chars.begin() == 99 && chars.Count('a') == 99);
+
+    // Сравнение сначала проверяет размеры
+    SimpleVector<int> prefix;
+    prefix.Assign(ints.begin(), ints.begin() + 10);
+    assert(prefix != ints && prefix < ints && !(ints < prefix));
+    SimpleVector<int> same(ints);
+    assert(same == ints && !(same < ints));
+    same[999] = -1;
+    assert(same != ints && same < ints && ints > same);
+
+    // Для чисел с плавающей точкой сохраняется поэлементная семантика: NaN != NaN, -0.0 == 0.0
+    SimpleVector<double> doubles(33, 1.0);
+    SimpleVector<double> other(doubles);
+    other[32] = 2.0;
+    assert(doubles != other && doubles < other && other.Find(2.0) - other.begin() == 32);
+    doubles[5] = 0.0;
+    other = doubles;
+    other[5] = -0.0;
+    assert(doubles == other && other.Count(0.0) == 1);
+    other[5] = numeric_limits<double>::quiet_NaN();
+    assert(other != other && !other.Contains(other[5]));
+
+    SmallSimpleVector<int, 4> small{1, 2, 3};
+    assert(small.Contains(2) && small.Count(4) == 0 && small.Find(3) == small.end() - 1);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAlignedStorage() {
+    cout << "Test aligned storage"s << endl;
+    static_assert(PaddedGrowth<DoublingGrowth, 64>::NextCapacity(0, 1, 4) == 16);
+    static_assert(PaddedGrowth<DoublingGrowth, 64>::NextCapacity(16, 17, 4) == 32);
+    static_assert(PaddedGrowth<DoublingGrowth, 64>::NextCapacity(0, 3, 24) == 3);
+    static_assert(AlignedAllocator<float, 64>::PaddedBytes(17) == 128);
+
+    auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    };
+    AlignedSimpleVector<float> floats;
+    for (int i = 0; i < 100; ++i) {
+        floats.PushBack(static_cast<float>(i));
+        assert(is_aligned(floats.begin(), 64) && floats.GetCapacity() % 16 == 0);
+    }
+    assert(floats[99] == 99.0f);
+
+    // Ёмкость кратна ширине вектора сразу после создания, Reserve, Assign и ShrinkToFit
+    AlignedSimpleVector<double, 128> doubles(5, 1.5);
+    assert(is_aligned(doubles.begin(), 128) && doubles[4] == 1.5 && doubles.GetCapacity() == 16);
+    AlignedSimpleVector<double, 128> copy(doubles);
+    assert(is_aligned(copy.begin(), 128) && copy == doubles && copy.GetCapacity() == 16);
+    AlignedSimpleVector<float> reserved;
+    reserved.Reserve(17);
+    assert(reserved.GetCapacity() == 32);
+    reserved.Assign(doubles.begin(), doubles.end());
+    reserved.ShrinkToFit();
+    assert(reserved.GetCapacity() == 16 && reserved.GetSize() == 5);
+    AlignedSimpleVector<float> assigned;
+    assigned.Assign(copy.begin(), copy.end());
+    assert(assigned.GetCapacity() == 16);
+    copy.Insert(copy.begin(), 20, 0.5);
+    assert(is_aligned(copy.begin(), 128) && copy.GetCapacity() % 16 == 0 && copy[20] == 1.5);
+
+    AlignedSimpleVector<string> strings{"a"s, "b"s};
+    strings.PushBack("c"s);
+    assert(is_aligned(strings.begin(), 64) && strings[2] == "c"s);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestAdoptDetach() {
+    cout << "Test adopt and detach"s << endl;
+    // Буфер из malloc, как у C API
+    int* raw = static_cast<int*>(malloc(8 * sizeof(int)));
+    for (int i = 0; i < 5; ++i) {
+        raw[i] = i;
+    }
+    static int frees = 0;
+    frees = 0;
+    SimpleVector<int> v;
+    v.Adopt(raw, 5, 8, [](int* ptr) {
+        ++frees;
+        free(ptr);
+    });
+    assert(v.begin() == raw && v.GetSize() == 5 && v.GetCapacity() == 8 && v.IsExternal());
+    v.PushBack(5);
+    assert(v.begin() == raw && frees == 0);
+    // При реаллокации чужой буфер освобождается через deleter
+    v.Resize(20);
+    assert(v.begin() != raw && frees == 1 && !v.IsExternal() && v[5] == 5);
+
+    // Detach и Adopt передают буфер между векторами без копирования
+    const int* data = v.begin();
+    SimpleVectorBuffer<int> buffer = v.Detach();
+    assert(v.IsEmpty() && v.GetCapacity() == 0 && buffer.data == data && buffer.size == 20);
+    SimpleVector<int> other{1, 2, 3};
+    other.Adopt(buffer);
+    assert(other.begin() == data && other.GetSize() == 20 && other[4] == 4);
+
+    // Непустой принятый буфер освобождается вместе с вектором
+    {
+        SimpleVector<string> strings;
+        string* memory = static_cast<string*>(malloc(2 * sizeof(string)));
+        new (memory) string("adopted"s);
+        strings.Adopt(memory, 1, 2, [](string* ptr) {
+            ++frees;
+            free(ptr);
+        });
+        strings.PushBack("second"s);
+        assert(strings[0] == "adopted"s && strings[1] == "second"s);
+    }
+    assert(frees == 2);
+
+    // Буфер, отданный Detach после Adopt с deleter, освобождается прежним способом
+    int* owned = static_cast<int*>(malloc(sizeof(int)));
+    *owned = 7;
+    SimpleVector<int> external;
+    external.Adopt(owned, 1, 1, [](int* ptr) {
+        ++frees;
+        free(ptr);
+    });
+    SimpleVectorBuffer<int> returned = external.Detach();
+    assert(returned.data == owned && *returned.data == 7 && frees == 2);
+    free(returned.data);
+
+    // Deleter уходит вместе с буфером при перемещении и обмене, со своим состоянием
+    {
+        int counts[2] = {0, 0};
+        SimpleVector<int> first;
+        first.Adopt(static_cast<int*>(malloc(4 * sizeof(int))), 0, 4, [&counts](int* ptr) {
+            ++counts[0];
+            free(ptr);
+        });
+        SimpleVector<int> second;
+        second.Adopt(static_cast<int*>(malloc(2 * sizeof(int))), 0, 2, [&counts](int* ptr) {
+            ++counts[1];
+            free(ptr);
+        });
+        first.swap(second);
+        assert(first.GetCapacity() == 2 && second.GetCapacity() == 4 && first.IsExternal());
+        SimpleVector<int> moved(std::move(first));
+        assert(moved.GetCapacity() == 2 && moved.IsExternal() && !first.IsExternal());
+        moved = SimpleVector<int>();
+        assert(counts[0] == 0 && counts[1] == 1);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestMappedSimpleVector() {
+    cout << "Test mapped simple vector"s << endl;
+    struct Record {
+        uint32_t id;
+        double value;
+    };
+    const string path = (filesystem::temp_directory_path() / "simple_vector_mapped_test.bin").string();
+    filesystem::remove(path);
+    {
+        MappedSimpleVector<Record> records(path);
+        assert(records.IsOpen() && records.IsEmpty());
+        for (uint32_t i = 0; i < 10000; ++i) {
+            records.PushBack({i, i * 0.5});
+        }
+        assert(records.GetSize() == 10000 && records.GetCapacity() >= 10000);
+        assert(records[1234].id == 1234 && records.At(9999).value == 9999 * 0.5);
+        records.Flush();
+        // Sync сохраняет число записей: файл обрезан до размера, записи не переехали
+        const Record* first = records.begin();
+        records.Sync();
+        assert(filesystem::file_size(path) == 10000 * sizeof(Record));
+        assert(records.GetCapacity() == 10000 && records.begin() == first && records[9999].id == 9999);
+        {
+            const MappedSimpleVector<Record> reader(path, MappingMode::kReadOnly);
+            assert(reader.GetSize() == 10000 && reader[1234].id == 1234);
+        }
+        records.PushBack({10000, 0.0});
+        records.PopBack();
+    }
+    // При закрытии файл обрезан до размера, а при повторном открытии записи на месте
+    assert(filesystem::file_size(path) == 10000 * sizeof(Record));
+    {
+        MappedSimpleVector<Record> records(path);
+        assert(records.GetSize() == 10000 && records[42].id == 42);
+        records.Resize(10005);
+        assert(records[10004].id == 0 && records[9999].id == 9999);
+        records.PopBack();
+    }
+    {
+        const MappedSimpleVector<Record> read_only(path, MappingMode::kReadOnly);
+        assert(read_only.GetSize() == 10004);
+        uint64_t sum = 0;
+        for (const Record& record : read_only) {
+            sum += record.id;
+        }
+        assert(sum == 9999ull * 10000 / 2);
+        try {
+            read_only.At(10004);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    MappedSimpleVector<Record> read_only(path, MappingMode::kReadOnly);
+    try {
+        read_only.PushBack({1, 1.0});
+        assert(false);
+    } catch (const logic_error&) {
+    }
+    MappedSimpleVector<Record> moved(std::move(read_only));
+    assert(!read_only.IsOpen() && moved.GetSize() == 10004);
+    moved.Close();
+    filesystem::remove(path);
+
+    // Неудачный рост возвращает файлу прежнюю длину. Чтобы mremap отказал, дочерний процесс
+    // ограничивает себе адресное пространство
+    {
+        MappedSimpleVector<double> values(path);
+        values.PushBack(1.0);
+        values.Sync();
+        const pid_t child = ::fork();
+        if (child == 0) {
+            size_t pages = 0;
+            ifstream("/proc/self/statm") >> pages;
+            rlimit limit{};
+            limit.rlim_cur = limit.rlim_max = pages * static_cast<size_t>(::sysconf(_SC_PAGESIZE)) + (size_t{1} << 30);
+            ::setrlimit(RLIMIT_AS, &limit);
+            bool failed = false;
+            try {
+                values.Reserve(size_t{1} << 39);
+            } catch (const system_error&) {
+                failed = true;
+            }
+            ::_exit(failed && filesystem::file_size(path) == sizeof(double) ? 0 : 1);
+        }
+        int status = 0;
+        const pid_t waited = ::waitpid(child, &status, 0);
+        assert(waited == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    assert(filesystem::file_size(path) == sizeof(double));
+    filesystem::remove(path);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSerialization() {
+    cout << "Test serialization"s << endl;
+    SimpleVector<int> ints(1000);
+    iota(ints.begin(), ints.end(), -500);
+    stringstream buffer;
+    Save(ints, buffer);
+    assert(buffer.str().size() == 20 + 1000 * sizeof(int));
+    SimpleVector<int> loaded{1, 2, 3};
+    Load(loaded, buffer);
+    assert(loaded == ints && loaded.GetCapacity() == 1000);
+
+    SimpleVector<string> strings{"a"s, ""s, "long enough to live on the heap"s};
+    stringstream string_buffer;
+    Save(strings, string_buffer);
+    SimpleVector<string> loaded_strings;
+    Load(loaded_strings, string_buffer);
+    assert(loaded_strings == strings);
+
+    // Ошибки формата не портят вектор
+    stringstream truncated(buffer.str().substr(0, 100));
+    try {
+        Load(loaded, truncated);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+    assert(loaded == ints);
+    stringstream ints_again(buffer.str());
+    SimpleVector<int64_t> wrong_type;
+    try {
+        Load(wrong_type, ints_again);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+
+    // Файловый дескриптор
+    const string path = (filesystem::temp_directory_path() / "simple_vector_serialization_test.bin").string();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    Save(ints, fd);
+    ::lseek(fd, 0, SEEK_SET);
+    SimpleVector<int> from_fd;
+    Load(from_fd, fd);
+    assert(from_fd == ints);
+    ::close(fd);
+    filesystem::remove(path);
+
+    // Порционное чтение резервирует память один раз
+    stringstream stream(buffer.str());
+    SimpleVectorReader<int> reader(stream);
+    assert(reader.GetSize() == 1000);
+    SimpleVector<int> chunked;
+    assert(reader.ReadChunk(chunked, 300) == 300 && chunked.GetCapacity() == 1000);
+    ResetVectorStats();
+    reader.ReadAll(chunked, 128);
+    assert(chunked == ints && reader.GetRemaining() == 0 && GetVectorStats().reallocations == 0);
+
+    stringstream string_stream(string_buffer.str());
+    SimpleVectorReader<string> string_reader(string_stream);
+    SimpleVector<string> chunked_strings;
+    while (string_reader.ReadChunk(chunked_strings, 2) != 0) {
+    }
+    assert(chunked_strings == strings);
+
+    // Порционное чтение из файлового дескриптора
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    Save(ints, fd);
+    ::lseek(fd, 0, SEEK_SET);
+    SimpleVectorReader<int> fd_reader(fd);
+    SimpleVector<int> from_fd_chunks;
+    fd_reader.ReadAll(from_fd_chunks, 100);
+    assert(from_fd_chunks == ints && from_fd_chunks.GetCapacity() == 1000);
+    ::close(fd);
+    filesystem::remove(path);
+
+    // Размер из заголовка не приводит к огромному выделению: с известной длиной входа он
+    // проверяется сразу, из канала вектор растёт, пока данные есть
+    string huge = buffer.str().substr(0, 20 + 3 * sizeof(int));
+    for (int i = 0; i < 8; ++i) {
+        huge[12 + i] = i == 5 ? '\x01' : '\0';
+    }
+    stringstream huge_stream(huge);
+    try {
+        Load(loaded, huge_stream);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+    int pipe_fds[2];
+    int pipe_result = ::pipe(pipe_fds);
+    assert(pipe_result == 0);
+    ssize_t written = ::write(pipe_fds[1], huge.data(), huge.size());
+    assert(written == static_cast<ssize_t>(huge.size()));
+    ::close(pipe_fds[1]);
+    try {
+        Load(loaded, pipe_fds[0]);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+    ::close(pipe_fds[0]);
+    assert(loaded == ints);
+
+    SimpleVector<string> one_string{"abc"s};
+    stringstream long_string;
+    Save(one_string, long_string);
+    string long_string_data = long_string.str();
+    long_string_data[20 + 5] = '\x01';
+    pipe_result = ::pipe(pipe_fds);
+    assert(pipe_result == 0);
+    written = ::write(pipe_fds[1], long_string_data.data(), long_string_data.size());
+    assert(written == static_cast<ssize_t>(long_string_data.size()));
+    ::close(pipe_fds[1]);
+    try {
+        Load(loaded_strings, pipe_fds[0]);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+    ::close(pipe_fds[0]);
+    stringstream long_string_stream(long_string_data);
+    try {
+        Load(loaded_strings, long_string_stream);
+        assert(false);
+    } catch (const SerializationError&) {
+    }
+    assert(loaded_strings == strings);
+
+    // Из канала длина неизвестна: вектор растёт по политике роста, а не порцию за порцией
+    SimpleVector<int> many(1000000);
+    iota(many.begin(), many.end(), 0);
+    pipe_result = ::pipe(pipe_fds);
+    assert(pipe_result == 0);
+    thread pipe_writer([&many, write_fd = pipe_fds[1]] {
+        Save(many, write_fd);
+        ::close(write_fd);
+    });
+    SimpleVectorReader<int> pipe_reader(pipe_fds[0]);
+    SimpleVector<int> from_pipe;
+    ResetVectorStats();
+    pipe_reader.ReadAll(from_pipe, 128);
+    const VectorStatsSnapshot pipe_stats = GetVectorStats();
+    pipe_writer.join();
+    ::close(pipe_fds[0]);
+    assert(from_pipe == many);
+    assert(pipe_stats.reallocations <= 25 && pipe_stats.elements_relocated < 2 * many.GetSize());
+    cout << "Done!"s << endl << endl;
+}
+
+void TestCowSimpleVector() {
+    cout << "Test copy-on-write simple vector"s << endl;
+    CowSimpleVector<string> original{"a"s, "b"s, "c"s};
+    assert(original.GetUseCount() == 1 && !original.IsShared());
+
+    // Копирование не трогает элементы
+    CowSimpleVector<string> snapshot = original;
+    const CowSimpleVector<string>& reader = snapshot;
+    assert(original.IsShared() && snapshot.GetUseCount() == 2);
+    assert(as_const(original).begin() == reader.begin() && reader[1] == "b"s && reader == original);
+
+    // Первая запись клонирует буфер, вторая — уже нет
+    original[0] = "x"s;
+    assert(!original.IsShared() && !snapshot.IsShared());
+    assert(reader[0] == "a"s && as_const(original)[0] == "x"s && reader != original);
+    original.PushBack("d"s);
+    const string* data = as_const(original).begin();
+    original[1] = "y"s;
+    assert(as_const(original).begin() == data && reader[1] == "b"s);
+
+    // Позиция, взятая до клонирования, пересчитывается в индекс
+    CowSimpleVector<string> copy = snapshot;
+    copy.Insert(as_const(copy).begin() + 1, "inserted"s);
+    assert(copy.GetSize() == 4 && as_const(copy)[1] == "inserted"s && reader.GetSize() == 3);
+    copy.Erase(as_const(copy).begin(), as_const(copy).begin() + 2);
+    assert(copy.GetSize() == 2 && as_const(copy)[0] == "b"s);
+
+    // Клонирование при Resize и Clear разделяемого буфера без копирования
+    CowSimpleVector<string> resized = snapshot;
+    resized.Resize(1);
+    assert(resized.GetSize() == 1 && reader.GetSize() == 3);
+    CowSimpleVector<string> cleared = snapshot;
+    cleared.Clear();
+    assert(cleared.IsEmpty() && snapshot.GetUseCount() == 1 && reader[2] == "c"s);
+
+    SimpleVector<int> source{1, 2, 3};
+    const int* source_data = source.begin();
+    CowSimpleVector<int> adopted(std::move(source));
+    assert(as_const(adopted).begin() == source_data && source.IsEmpty());
+
+    // Снимок передаётся потокам по значению, каждый поток пишет в свою копию
+    vector<thread> threads;
+    atomic<int> sum{0};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([snapshot = adopted, i, &sum]() mutable {
+            snapshot[0] = i;
+            sum += snapshot[0] + as_const(snapshot)[2];
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    assert(sum == 0 + 1 + 2 + 3 + 4 * 3 && as_const(adopted)[0] == 1 && adopted.GetUseCount() == 1);
+
+    // Ссылка, выданная до копирования, не меняет копию: такой буфер копия клонирует
+    CowSimpleVector<string> writer{"a"s, "b"s};
+    string& kept = writer[0];
+    CowSimpleVector<string> frozen = writer;
+    kept = "changed"s;
+    assert(as_const(frozen)[0] == "a"s && as_const(writer)[0] == "changed"s && !writer.IsShared());
+    string* kept_iterator = writer.begin();
+    CowSimpleVector<string> frozen_again(writer);
+    *kept_iterator = "again"s;
+    assert(as_const(frozen_again)[0] == "changed"s);
+    // PushBack ссылок не отдаёт, а после AllowSharing и Clear буфер снова разделяется
+    CowSimpleVector<int> counters{1, 2};
+    counters.PushBack(3);
+    CowSimpleVector<int> shared_counters = counters;
+    assert(counters.IsShared());
+    writer.AllowSharing();
+    CowSimpleVector<string> shared_writer = writer;
+    assert(writer.IsShared());
+    frozen.EmplaceBack("x"s);
+    frozen.Clear();
+    CowSimpleVector<string> shared_frozen = frozen;
+    assert(frozen.IsShared());
+    cout << "Done!"s << endl << endl;
+}
+
+void TestConcurrentSimpleVector() {
+    cout << "Test concurrent simple vector"s << endl;
+    ConcurrentSimpleVector<string, 4> strings;
+    assert(strings.PushBack("a"s) == 0 && strings.EmplaceBack(3, 'b') == 1 && strings.GetSize() == 2);
+    const string* first = &strings[0];
+    for (int i = 0; i < 1000; ++i) {
+        strings.PushBack(to_string(i));
+    }
+    // Рост не перемещает элементы
+    assert(&strings[0] == first && strings[1] == "bbb"s && strings.At(1001) == "999"s);
+    try {
+        strings.At(1002);
+        assert(false);
+    } catch (const out_of_range&) {
+    }
+
+    const size_t kThreads = 32;
+    const size_t kPerThread = 5000;
+    ConcurrentSimpleVector<uint64_t> log;
+    log.Reserve(100);
+    atomic<bool> done{false};
+    // Читатель видит только опубликованные элементы, и граница не убывает
+    thread reader([&] {
+        size_t last_size = 0;
+        while (!done.load()) {
+            size_t size = log.GetSize();
+            assert(size >= last_size);
+            if (size != 0) {
+                assert(log[size - 1] % kPerThread < kPerThread);
+            }
+            last_size = size;
+        }
+    });
+    vector<thread> producers;
+    vector<vector<size_t>> indices(kThreads);
+    for (size_t t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&, t] {
+            for (size_t i = 0; i < kPerThread; ++i) {
+                indices[t].push_back(log.PushBack(t * kPerThread + i));
+            }
+        });
+    }
+    for (thread& producer : producers) {
+        producer.join();
+    }
+    done = true;
+    reader.join();
+
+    assert(log.GetSize() == kThreads * kPerThread);
+    vector<bool> seen(kThreads * kPerThread);
+    for (size_t t = 0; t < kThreads; ++t) {
+        for (size_t i = 0; i < kPerThread; ++i) {
+            size_t index = indices[t][i];
+            assert(log[index] == t * kPerThread + i && !seen[log[index]]);
+            seen[log[index]] = true;
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestChunkedSimpleVector() {
+    cout << "Test chunked simple vector"s << endl;
+    ChunkedSimpleVector<string, 4> v;
+    v.PushBack("first"s);
+    const string* first = &v[0];
+    for (int i = 1; i < 10; ++i) {
+        v.PushBack(to_string(i));
+    }
+    // Рост добавляет блоки, не перемещая элементы
+    assert(&v[0] == first && v.GetSize() == 10 && v.GetCapacity() == 12);
+    assert(v[9] == "9"s && v.At(4) == "4"s);
+    // Аргумент может ссылаться на элемент самого вектора, даже когда нужен новый блок
+    v.PushBack(v[0]);
+    v.PushBack(v[1]);
+    v.EmplaceBack(v[0]);
+    assert(v.GetSize() == 13 && v[12] == "first"s && v[10] == "first"s);
+
+    // Итераторы произвольного доступа
+    assert(v.end() - v.begin() == 13 && *(v.begin() + 9) == "9"s && v.begin()[3] == "3"s);
+    ChunkedSimpleVector<string, 4>::ConstIterator it = v.begin();
+    assert(it == v.cbegin() && (it + 13) == v.cend());
+    size_t total = 0;
+    for (const string& s : v) {
+        total += s.size();
+    }
+    assert(total == 5 * 3 + 9 + 1 && v[11] == "1"s);
+
+    ChunkedSimpleVector<string, 4> copy(v);
+    assert(copy == v);
+    copy.PopBack();
+    assert(copy != v && copy.GetSize() == 12);
+    while (copy.GetSize() > 5) {
+        copy.PopBack();
+    }
+    assert(copy.GetCapacity() == 16);
+    copy.ShrinkToFit();
+    assert(copy.GetCapacity() == 8 && copy[4] == "4"s);
+
+    ChunkedSimpleVector<int, 1000> ints(2500);
+    assert(ints.GetCapacity() == 3000 && ints[2499] == 0);
+    iota(ints.begin(), ints.end(), 0);
+    sort(ints.begin(), ints.end(), greater<>());
+    assert(ints[0] == 2499 && ints[2499] == 0);
+    ints.Resize(10);
+    assert(ints.GetSize() == 10 && ints[9] == 2490);
+    ChunkedSimpleVector<int, 1000> moved(std::move(ints));
+    assert(ints.IsEmpty() && moved.GetSize() == 10);
+    moved.Clear();
+    assert(moved.IsEmpty() && moved.GetCapacity() == 0);
+
+    // Исключение из конструктора элемента: созданные элементы разрушаются, блоки освобождаются
+    ThrowingOnCreate::created = 50000 - 10;
+    ThrowingOnCreate::alive = 0;
+    try {
+        ChunkedSimpleVector<ThrowingOnCreate, 4> failed(100);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    assert(ThrowingOnCreate::alive == 0);
+    ChunkedSimpleVector<ThrowingOnCopy, 4> source(10);
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        ThrowingOnCopy::copies_left = 7;
+        try {
+            if (attempt == 0) {
+                ChunkedSimpleVector<ThrowingOnCopy, 4> failed(source);
+            } else if (attempt == 1) {
+                ChunkedSimpleVector<ThrowingOnCopy, 4> failed(10, ThrowingOnCopy());
+            } else {
+                ChunkedSimpleVector<ThrowingOnCopy, 4> failed{{}, {}, {}, {}, {}, {}, {}, {}};
+            }
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+// Копируемый тип, перемещение которого noexcept только при NoexceptMove; копирование
+// можно заставить бросить
+template <bool NoexceptMove>
+struct CopyMoveCounter {
+    inline static int copies = 0;
+    inline static int moves = 0;
+    inline static int copies_until_throw = -1;
+
+    explicit CopyMoveCounter(int value = 0)
+        : value(value) {
+    }
+    CopyMoveCounter(const CopyMoveCounter& other)
+        : value(other.value) {
+        if (copies_until_throw == 0) {
+            throw runtime_error("copy failed");
+        }
+        --copies_until_throw;
+        ++copies;
+    }
+    CopyMoveCounter(CopyMoveCounter&& other) noexcept(NoexceptMove)
+        : value(other.value) {
+        ++moves;
+    }
+    CopyMoveCounter& operator=(const CopyMoveCounter&) = default;
+    CopyMoveCounter& operator=(CopyMoveCounter&&) = default;
+
+    int value;
+};
+
+using ThrowingMove = CopyMoveCounter<false>;
+using NothrowMove = CopyMoveCounter<true>;
+
+void TestMoveIfNoexcept() {
+    cout << "Test move_if_noexcept reallocation"s << endl;
+    SimpleVector<ThrowingMove> v;
+    v.Reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        v.EmplaceBack(i);
+    }
+    ThrowingMove::copies = ThrowingMove::moves = 0;
+    // При реаллокации элементы с бросающим перемещением копируются...
+    v.EmplaceBack(4);
+    assert(ThrowingMove::copies == 4 && ThrowingMove::moves == 0 && v.GetSize() == 5);
+
+    // ...поэтому исключение посреди реаллокации не портит вектор
+    v.ShrinkToFit();
+    const ThrowingMove* data = v.begin();
+    ThrowingMove::copies_until_throw = 2;
+    try {
+        v.Insert(v.begin() + 1, ThrowingMove(100));
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    ThrowingMove::copies_until_throw = -1;
+    assert(v.begin() == data && v.GetSize() == 5);
+    for (int i = 0; i < 5; ++i) {
+        assert(v[i].value == i);
+    }
+
+    // Для типов с noexcept-перемещением вставка копии при росте перемещает старые элементы
+    SimpleVector<NothrowMove> values;
+    values.EmplaceBack(1);
+    values.EmplaceBack(2);
+    values.ShrinkToFit();
+    NothrowMove::copies = NothrowMove::moves = 0;
+    const NothrowMove value(3);
+    values.Insert(values.begin(), value);
+    assert(NothrowMove::copies == 1 && NothrowMove::moves == 2 && values[0].value == 3 && values[2].value == 2);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestCopyAssignmentReuse() {
+    cout << "Test copy assignment reuse"s << endl;
+    using Strings = SimpleVector<string, CountingAllocator<string>>;
+    Strings front(100, "front"s);
+    Strings back(100, "back"s);
+    Strings small(10, "small"s);
+    CountingAllocator<string>::allocations = 0;
+    CountingAllocator<string>::deallocations = 0;
+    // Двойная буферизация: присваивание векторов одного размера не выделяет буфер вектора
+    for (int frame = 0; frame < 10; ++frame) {
+        back = front;
+        swap(front, back);
+    }
+    assert(CountingAllocator<string>::allocations == 0 && CountingAllocator<string>::deallocations == 0);
+    assert(front == back && back[99] == "front"s);
+
+    // Меньший вектор: лишние элементы разрушаются, ёмкость сохраняется
+    const string* data = back.begin();
+    back = small;
+    assert(back.begin() == data && back.GetSize() == 10 && back.GetCapacity() == 100 && back == small);
+    // Больший вектор, помещающийся в ёмкость: недостающие элементы создаются на месте
+    back = front;
+    assert(back.begin() == data && back.GetSize() == 100 && back[50] == "front"s);
+    assert(CountingAllocator<string>::allocations == 0);
+
+    // Ёмкости не хватает — выделяется новый буфер
+    small = front;
+    assert(small.GetSize() == 100 && small == front && CountingAllocator<string>::allocations == 1);
+
+    SmallSimpleVector<int, 4> inline_lhs{1, 2, 3};
+    const SmallSimpleVector<int, 4> inline_rhs{4, 5};
+    inline_lhs = inline_rhs;
+    assert(inline_lhs.IsSmall() && inline_lhs == inline_rhs);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestResizeModes() {
+    cout << "Test resize with value and uninitialized resize"s << endl;
+    SimpleVector<string> v{"a"s, "b"s};
+    v.Resize(5, "x"s);
+    assert(v.GetSize() == 5 && v[1] == "b"s && v[2] == "x"s && v[4] == "x"s);
+    // Значение может быть элементом самого вектора, даже если нужна реаллокация
+    v.Resize(v.GetCapacity() + 3, v[0]);
+    assert(v[v.GetSize() - 1] == "a"s && v[4] == "x"s);
+    v.Resize(1, "ignored"s);
+    assert(v.GetSize() == 1 && v[0] == "a"s);
+
+    SimpleVector<int> buffer{1, 2, 3};
+    buffer.ResizeUninitialized(1000);
+    assert(buffer.GetSize() == 1000 && buffer.GetCapacity() >= 1000 && buffer[2] == 3);
+    for (size_t i = 3; i < buffer.GetSize(); ++i) {
+        buffer[i] = static_cast<int>(i);
+    }
+    assert(buffer[999] == 999);
+    buffer.ResizeUninitialized(10);
+    assert(buffer.GetSize() == 10 && buffer[9] == 9);
+    // Внутри ёмкости память не трогается: значения остаются прежними
+    buffer.ResizeUninitialized(20);
+    assert(buffer[15] == 15);
+
+    SmallSimpleVector<double, 4> small;
+    small.Resize(3, 1.5);
+    assert(small.IsSmall() && small[2] == 1.5);
+    small.ResizeUninitialized(8);
+    assert(!small.IsSmall() && small.GetSize() == 8 && small[0] == 1.5);
+    cout << "Done!"s << endl << endl;
+}
+
+constexpr StaticSimpleVector<int, 8> MakeStaticTable() {
+    StaticSimpleVector<int, 8> table;
+    for (int i = 0; i < 5; ++i) {
+        table.PushBack(i * i);
+    }
+    table.Insert(table.begin() + 1, 100);
+    table.Erase(table.begin());
+    return table;
+}
+
+void TestStaticSimpleVector() {
+    cout << "Test static simple vector"s << endl;
+    // Для тривиальных типов вектор строится при компиляции
+    constexpr StaticSimpleVector<int, 8> table = MakeStaticTable();
+    static_assert(table.GetSize() == 5 && table[0] == 100 && table[1] == 1 && table[4] == 16);
+    static_assert(StaticSimpleVector<int, 8>::GetCapacity() == 8);
+#ifndef SIMPLE_VECTOR_HAS_CONSTEXPR_TRIVIAL_INIT
+    static_assert(std::is_trivially_copyable_v<StaticSimpleVector<int, 8>>);
+#endif
+    static_assert(sizeof(StaticSimpleVector<int, 4>) == sizeof(size_t) + 4 * sizeof(int));
+    // Копируются только элементы, а не весь массив
+    StaticSimpleVector<int, 1024> ints{1, 2, 3};
+    StaticSimpleVector<int, 1024> ints_copy = ints;
+    assert(ints_copy == ints && ints_copy.GetSize() == 3);
+    ints_copy.PushBack(4);
+    ints = ints_copy;
+    assert(ints.GetSize() == 4 && ints[3] == 4);
+
+    StaticSimpleVector<string, 4> v{"b"s, "d"s};
+    v.Insert(v.begin(), "a"s);
+    v.Insert(v.begin() + 2, v[0]);
+    assert(v.GetSize() == 4 && v[0] == "a"s && v[1] == "b"s && v[2] == "a"s && v[3] == "d"s);
+    try {
+        v.PushBack("e"s);
+        assert(false);
+    } catch (const length_error&) {
+    }
+    assert(v.GetSize() == 4);
+    v.Erase(v.begin() + 1, v.begin() + 3);
+    assert(v.GetSize() == 2 && v[0] == "a"s && v[1] == "d"s);
+
+    StaticSimpleVector<string, 4> copy = v;
+    copy.Resize(3, "z"s);
+    assert(copy[2] == "z"s && v < copy && v != copy);
+    v = copy;
+    assert(v == copy);
+    StaticSimpleVector<string, 4> other{"q"s};
+    other.swap(v);
+    assert(other == copy && v.GetSize() == 1 && v[0] == "q"s);
+    v = std::move(other);
+    assert(v == copy);
+    v.PopBack();
+    v.Clear();
+    assert(v.IsEmpty());
+    try {
+        v.Resize(5);
+        assert(false);
+    } catch (const length_error&) {
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
+// Таблица квадратов нечётных чисел, собранная PushBack, Insert и Erase при компиляции
+constexpr SimpleVector<int> BuildOddSquares() {
+    SimpleVector<int> squares;
+    for (int i = 0; i < 10; ++i) {
+        squares.PushBack(i * i);
+    }
+    squares.Insert(squares.begin(), 3, -1);
+    squares.Erase(squares.begin(), squares.begin() + 3);
+    EraseIf(squares, [](int value) {
+        return value % 2 == 0;
+    });
+    return squares;
+}
+
+consteval bool CheckConstexprOperations() {
+    SimpleVector<int> v{1, 2, 3};
+    SimpleVector<int> copy = v;
+    copy.Insert(copy.begin() + 1, copy[2]);
+    copy.Resize(6, 7);
+    SimpleVector<int> moved = std::move(copy);
+    int sum = 0;
+    for (int value : moved) {
+        sum += value;
+    }
+    v.Reserve(100);
+    v.ShrinkToFit();
+    v.PopBack();
+    return sum == 1 + 3 + 2 + 3 + 7 + 7 && v < moved && v != moved && v == SimpleVector<int>{1, 2} &&
+           moved.GetSize() == 6 && copy.IsEmpty();
+}
+#endif
+
+void TestConstexprSimpleVector() {
+    cout << "Test constexpr simple vector"s << endl;
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
+    static_assert(CheckConstexprOperations());
+    constexpr auto kOddSquares = ToArray<BuildOddSquares>();
+    static_assert(kOddSquares.size() == 5 && kOddSquares[0] == 1 && kOddSquares[4] == 81);
+    // Те же функции работают и во время выполнения
+    SimpleVector<int> runtime = BuildOddSquares();
+    assert(ToArray<5>(runtime) == kOddSquares);
+    try {
+        (void)ToArray<4>(runtime);
+        assert(false);
+    } catch (const length_error&) {
+    }
+#else
+    cout << "constexpr SimpleVector requires C++20, skipped"s << endl;
+#endif
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSoASimpleVector() {
+    cout << "Test structure-of-arrays simple vector"s << endl;
+    SoASimpleVector<float, int, string> particles;
+    for (int i = 0; i < 100; ++i) {
+        particles.PushBack({i * 0.5f, i, to_string(i)});
+    }
+    particles.EmplaceBack(1.0f, -1, "last"s);
+    assert(particles.GetSize() == 101 && particles.GetCapacity() >= 101);
+
+    // Каждое поле лежит в своём непрерывном буфере
+    auto weights = particles.Column<0>();
+    assert(weights.GetSize() == 101 && weights.Data() == particles.Data<0>());
+    float total = 0;
+    for (float weight : weights) {
+        total += weight;
+    }
+    assert(total == 0.5f * 99 * 100 / 2 + 1.0f);
+    for (int& id : particles.Column<1>()) {
+        id *= 2;
+    }
+    auto [weight, id, name] = particles[10];
+    assert(weight == 5.0f && id == 20 && name == "10"s);
+    get<2>(particles[100]) = "changed"s;
+    assert(get<2>(particles.At(100)) == "changed"s);
+
+    // Аргументы могут ссылаться на сам вектор даже при реаллокации
+    SoASimpleVector<float, int, string> copy = particles;
+    copy.ShrinkToFit();
+    assert(copy.GetCapacity() == copy.GetSize() && copy == particles);
+    copy.EmplaceBack(get<0>(copy[0]), get<1>(copy[3]), get<2>(copy[5]));
+    assert(copy.GetSize() == 102 && get<1>(copy[101]) == 6 && get<2>(copy[101]) == "5"s && copy != particles);
+
+    copy.Resize(110);
+    assert(get<0>(copy[109]) == 0.0f && get<2>(copy[109]).empty());
+    copy.PopBack();
+    copy.Resize(3);
+    assert(copy.GetSize() == 3 && get<2>(copy[2]) == "2"s);
+    particles = std::move(copy);
+    assert(particles.GetSize() == 3 && copy.IsEmpty());
+
+    const auto& view = particles;
+    static_assert(is_same_v<decltype(view.Column<1>()), SoAColumn<const int>>);
+    assert(view.Column<1>()[2] == 4);
+    particles.Clear();
+    assert(particles.IsEmpty() && particles.GetCapacity() != 0);
+    cout << "Done!"s << endl << endl;
+}
+
+int SumView(SimpleVectorView<const int> view) {
+    return accumulate(view.begin(), view.end(), 0);
+}
+
+void TestSimpleVectorView() {
+    cout << "Test simple vector view"s << endl;
+    SimpleVector<int> v(10);
+    iota(v.begin(), v.end(), 0);
+    // Вектор неявно приводится к виду, константный — только к константному
+    assert(SumView(v) == 45);
+    static_assert(!is_convertible_v<const SimpleVector<int>&, SimpleVectorView<int>>);
+    static_assert(is_convertible_v<SimpleVectorView<int>, SimpleVectorView<const int>>);
+    static_assert(!is_convertible_v<SimpleVectorView<const int>, SimpleVectorView<int>>);
+
+    SimpleVectorView<int> middle = v.Slice(2, 5);
+    assert(middle.GetSize() == 5 && middle.Data() == v.begin() + 2 && middle[0] == 2);
+    for (int& value : middle.Slice(1, 2)) {
+        value *= 10;
+    }
+    assert(v[3] == 30 && v[4] == 40 && v[5] == 5);
+    assert(SumView(middle.Slice(3)) == 5 + 6);
+    assert(middle.Slice(5).IsEmpty());
+    try {
+        (void)middle.Slice(4, 2);
+        assert(false);
+    } catch (const out_of_range&) {
+    }
+
+    // Части для рабочих потоков покрывают вектор без пропусков и различаются не больше чем на 1
+    const SimpleVector<int>& cv = v;
+    size_t covered = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        SimpleVectorView<const int> chunk = cv.View().Chunk(i, 3);
+        assert(chunk.Data() == cv.begin() + covered && chunk.GetSize() == (i == 0 ? 4 : 3));
+        covered += chunk.GetSize();
+    }
+    assert(covered == v.GetSize());
+    assert(v.View() == cv.View() && v.Slice(0, 2) != v.Slice(1, 2));
+#ifdef __cpp_lib_span
+    span<const int> as_span = cv.View();
+    assert(as_span.size() == 10 && as_span[3] == 30);
+#endif
+
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+    // Замена буфера делает виды недействительными, сдвиги внутри буфера — нет
+    SimpleVectorView<const int> view = cv.View();
+    v.Insert(v.begin(), v.GetCapacity() - v.GetSize(), 0);
+    assert(view.IsValid());
+    v.PushBack(1);
+    assert(!view.IsValid() && !middle.IsValid() && v.View().IsValid());
+    SimpleVectorView<const int> before_swap = v.View();
+    SimpleVector<int> other;
+    other.swap(v);
+    assert(!before_swap.IsValid());
+#endif
+    cout << "Done!"s << endl << endl;
+}
+
+void TestDeferredReclamation() {
+    cout << "Test deferred reclamation"s << endl;
+    BufferReclaimer reclaimer;
+    using Alloc = DeferredAllocator<int>;
+    {
+        // Блоки от 1 КиБ освобождаются в фоновом потоке, меньшие — сразу
+        SimpleVector<int, Alloc> v(Alloc(reclaimer, 1024));
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        v = SimpleVector<int, Alloc>(10, 7, Alloc(reclaimer, 1024));
+        assert(v.GetSize() == 10 && v[9] == 7);
+    }
+    reclaimer.Flush();
+    // Отложены блоки на 256, 512 и 1024 элемента, пришедшие при росте и присваивании
+    assert(reclaimer.GetPendingBytes() == 0);
+    assert(reclaimer.GetReclaimedBytes() == (256 + 512 + 1024) * sizeof(int));
+
+    // Вектор целиком: элементы разрушаются не в вызывающем потоке
+    thread::id destroyed_on;
+    SimpleVector<shared_ptr<int>> owners;
+    owners.PushBack(shared_ptr<int>(new int(1), [&destroyed_on](int* ptr) {
+        destroyed_on = this_thread::get_id();
+        delete ptr;
+    }));
+    RetireAsync(std::move(owners), reclaimer);
+    assert(owners.IsEmpty());
+    reclaimer.Flush();
+    assert(destroyed_on != thread::id() && destroyed_on != this_thread::get_id());
+
+    // Вектор с отложенным аллокатором, разрушаемый самим фоновым потоком, освобождает память сразу
+    SimpleVector<int, Alloc> nested(2000, 1, Alloc(reclaimer, 1024));
+    const uint64_t before = reclaimer.GetReclaimedBytes();
+    RetireAsync(std::move(nested), reclaimer);
+    reclaimer.Flush();
+    assert(reclaimer.GetReclaimedBytes() == before + 2000 * sizeof(int) && reclaimer.GetPendingBytes() == 0);
+    cout << "Done!"s << endl << endl;
+}
+
+void TestSimpleVectorPool() {
+    cout << "Test simple vector pool"s << endl;
+    using Alloc = CountingAllocator<int>;
+    {
+        SimpleVectorPool<int, Alloc> pool;
+        // Конвейер: на каждом шаге два рабочих вектора. После разгона память не выделяется
+        auto step = [&pool](int round) {
+            auto input = pool.Acquire();
+            auto output = pool.Acquire();
+            for (int i = 0; i < 1000; ++i) {
+                input.PushBack(i + round);
+            }
+            for (int value : input) {
+                output.PushBack(value * 2);
+            }
+            assert(output.GetSize() == 1000 && output[999] == (999 + round) * 2);
+            pool.Release(std::move(input));
+            pool.Release(std::move(output));
+        };
+        step(0);
+        assert(pool.GetCachedCount() == 2);
+        const int allocations = Alloc::allocations;
+        for (int round = 1; round < 100; ++round) {
+            step(round);
+        }
+        assert(Alloc::allocations == allocations);
+
+        // Выданный вектор пуст, но сохранил ёмкость
+        auto reused = pool.Acquire();
+        assert(reused.IsEmpty() && reused.GetCapacity() >= 1000);
+        pool.Release(std::move(reused));
+        pool.Trim();
+        assert(pool.GetCachedCount() == 0);
+    }
+    {
+        SimpleVectorPoolOptions options;
+        options.max_cached_per_thread = 2;
+        options.max_cached_capacity = 100;
+        SimpleVectorPool<int> pool(options);
+        // Слишком большой и пустой векторы не кэшируются, лишние сверх предела тоже
+        pool.Release(SimpleVector<int>(1000));
+        pool.Release(SimpleVector<int>());
+        assert(pool.GetCachedCount() == 0);
+        pool.Release(pool.Acquire(10));
+        pool.Release(pool.Acquire(10));
+        pool.Release(SimpleVector<int>(10));
+        assert(pool.GetCachedCount() == 2);
+    }
+    {
+        SimpleVectorPoolOptions options;
+        options.trim_interval = 4;
+        SimpleVectorPool<int> pool(options);
+        // Всплеск: три вектора одновременно
+        auto a = pool.Acquire(16);
+        auto b = pool.Acquire(16);
+        auto c = pool.Acquire(16);
+        pool.Release(std::move(a));
+        pool.Release(std::move(b));
+        pool.Release(std::move(c));
+        pool.Release(pool.Acquire());
+        assert(pool.GetCachedCount() == 3);
+        // Дальше нужен только один: два ни разу не понадобившихся освобождаются
+        for (int i = 0; i < 4; ++i) {
+            pool.Release(pool.Acquire());
+        }
+        assert(pool.GetCachedCount() == 1);
+    }
+    {
+        // Списки у каждого потока свои; вектор можно вернуть из другого потока
+        SimpleVectorPool<int> pool;
+        auto shared = pool.Acquire(64);
+        size_t cached_in_worker = 0;
+        thread worker([&] {
+            assert(pool.GetCachedCount() == 0);
+            pool.Release(std::move(shared));
+            for (int i = 0; i < 100; ++i) {
+                auto v = pool.Acquire();
+                v.Resize(64);
+                pool.Release(std::move(v));
+            }
+            cached_in_worker = pool.GetCachedCount();
+        });
+        worker.join();
+        assert(cached_in_worker == 1);
+        assert(pool.GetCachedCount() == 0);
+    }
+    {
+        // Записи потока о разрушенных пулах не копятся
+        const size_t known = SimpleVectorPool<int>::GetThreadPoolCount();
+        for (int i = 0; i < 100; ++i) {
+            SimpleVectorPool<int> temporary;
+            temporary.Release(temporary.Acquire(8));
+        }
+        assert(SimpleVectorPool<int>::GetThreadPoolCount() <= known + 1);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
+void TestLargePageAllocator() {
+    cout << "Test large page allocator"s << endl;
+    LargePageOptions options;
+    options.threshold_bytes = 1 << 20;
+    options.parallel_first_touch = true;
+    options.first_touch_policy = ParallelPolicy{4, 1 << 12};
+    using Alloc = LargePageAllocator<int>;
+    Alloc alloc(options);
+    const size_t huge_page = Alloc::kHugePageSize;
+    {
+        // Малые блоки идут в operator new, большие отображаются с выравниванием по огромной странице
+        assert(!alloc.IsLargeBlock(1000) && alloc.IsLargeBlock(1 << 18));
+        int* small = alloc.allocate(1000);
+        alloc.deallocate(small, 1000);
+        int* large = alloc.allocate(1 << 18);
+        assert(reinterpret_cast<uintptr_t>(large) % huge_page == 0);
+        for (int i = 0; i < (1 << 18); ++i) {
+            large[i] = i;
+        }
+        // mremap переносит содержимое; хвост нового блока пуст
+        int* grown = alloc.reallocate(large, 1 << 18, 1 << 21);
+        assert(grown != nullptr);
+        assert(grown[0] == 0 && grown[(1 << 18) - 1] == (1 << 18) - 1 && grown[(1 << 21) - 1] == 0);
+        assert(alloc.reallocate(grown, 1 << 21, 1000) == nullptr);
+        alloc.deallocate(grown, 1 << 21);
+    }
+    {
+        // Вектор переходит порог при росте, дальше растёт через mremap
+        SimpleVector<int, Alloc> v(alloc);
+        for (int i = 0; i < 3'000'000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetAllocator().IsLargeBlock(v.GetCapacity()));
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % huge_page == 0);
+        bool intact = true;
+        for (int i = 0; i < 3'000'000; ++i) {
+            intact = intact && v[i] == i;
+        }
+        assert(intact);
+        v.Reserve(5'000'000);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 3'000'000 && v[2'999'999] == 2'999'999);
+        // Сжатие ниже порога возвращает буфер в operator new
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 10 && v[9] == 9);
+        assert(!v.GetAllocator().IsLargeBlock(v.GetCapacity()));
+    }
+    {
+        // Параллельное заполнение по тем же кускам, что и первое касание
+        SimpleVector<int, Alloc> filled(options.first_touch_policy, 1 << 20, 7, alloc);
+        assert(filled[0] == 7 && filled[(1 << 20) - 1] == 7);
+    }
+    {
+        // Привязка к узлу 0 и чередование по узлам; узел 0 есть в любой системе
+        LargePageOptions numa = options;
+        numa.numa_placement = NumaPlacement::kBind;
+        numa.numa_nodes = 1;
+        SimpleVector<double, LargePageAllocator<double>> bound(1 << 18, 1.5, LargePageAllocator<double>(numa));
+        bound.Resize(1 << 20, 2.5);
+        assert(bound[0] == 1.5 && bound[(1 << 20) - 1] == 2.5);
+        numa.numa_placement = NumaPlacement::kInterleave;
+        SimpleVector<double, LargePageAllocator<double>> interleaved(1 << 18, 0.5, LargePageAllocator<double>(numa));
+        assert(interleaved[(1 << 18) - 1] == 0.5);
+
+        // Пустая маска — ошибка mbind
+        numa.numa_nodes = 0;
+        bool thrown = false;
+        try {
+            LargePageAllocator<double>(numa).allocate(1 << 18);
+        } catch (const system_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    cout << "Done!"s << endl << endl;
+}
+
 int main() {
     TestTemporaryObjConstructor();
     TestTemporaryObjOperator();
@@ -159,5 +1927,34 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestUninitializedStorage();
+    TestEmplace();
+    TestTriviallyRelocatable();
+    TestAllocator();
+    TestSmallSimpleVector();
+    TestGrowthPolicy();
+    TestShrink();
+    TestRangeOperations();
+    TestRangeErase();
+    TestStats();
+    TestParallel();
+    TestSimdSearch();
+    TestAlignedStorage();
+    TestAdoptDetach();
+    TestMappedSimpleVector();
+    TestSerialization();
+    TestCowSimpleVector();
+    TestConcurrentSimpleVector();
+    TestChunkedSimpleVector();
+    TestMoveIfNoexcept();
+    TestCopyAssignmentReuse();
+    TestResizeModes();
+    TestStaticSimpleVector();
+    TestConstexprSimpleVector();
+    TestSoASimpleVector();
+    TestSimpleVectorView();
+    TestDeferredReclamation();
+    TestSimpleVectorPool();
+    TestLargePageAllocator();
     return 0;
 }
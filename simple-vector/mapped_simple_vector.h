@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "growth_policy.h"
+
+enum class MappingMode {
+    kReadOnly,
+    kReadWrite,
+};
+
+// Вектор записей фиксированного размера поверх отображённого в память файла (POSIX).
+// Файл хранит записи подряд без заголовка; при открытии размер вектора — длина файла,
+// делённая на sizeof(Type), поэтому открытие мгновенно, а страницы файла общие для всех
+// процессов, которые его отображают.
+//
+// Пока вектор открыт, длина файла равна ёмкости: рост идёт через ftruncate и переотображение.
+// Sync() и Close() обрезают файл до размера, так что число записей сохраняется вместе с ними;
+// после сбоя между Sync() в файле могут остаться нулевые записи из запаса ёмкости.
+// Flush() ставит изменённые страницы в очередь на запись, Sync() дожидается их записи на диск.
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector requires a trivially copyable type");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    MappedSimpleVector() noexcept = default;
+
+    // Открывает файл; в режиме kReadWrite создаёт его, если файла нет
+    explicit MappedSimpleVector(const std::string& path, MappingMode mode = MappingMode::kReadWrite) : mode_(mode) {
+        fd_ = mode == MappingMode::kReadOnly ? ::open(path.c_str(), O_RDONLY | O_CLOEXEC)
+                                             : ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        try {
+            struct stat file_stat;
+            if (::fstat(fd_, &file_stat) != 0) {
+                ThrowSystemError("fstat");
+            }
+            size_t file_size = static_cast<size_t>(file_stat.st_size);
+            if (file_size % sizeof(Type) != 0) {
+                throw std::runtime_error("File size is not a multiple of the record size");
+            }
+            size_ = file_size / sizeof(Type);
+            file_size_ = size_;
+            Map(size_);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedSimpleVector(const MappedSimpleVector&) = delete;
+    MappedSimpleVector& operator=(const MappedSimpleVector&) = delete;
+
+    MappedSimpleVector(MappedSimpleVector&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          file_size_(std::exchange(other.file_size_, 0)),
+          fd_(std::exchange(other.fd_, -1)),
+          mode_(other.mode_) {}
+
+    MappedSimpleVector& operator=(MappedSimpleVector&& other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            file_size_ = std::exchange(other.file_size_, 0);
+            fd_ = std::exchange(other.fd_, -1);
+            mode_ = other.mode_;
+        }
+        return *this;
+    }
+
+    // Ошибку закрытия здесь некому сообщить: чтобы узнать о ней, вызовите Close()
+    ~MappedSimpleVector() {
+        Release();
+    }
+
+    bool IsOpen() const noexcept {
+        return fd_ >= 0;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // В режиме kReadOnly страницы отображены только для чтения: писать через
+    // неконстантный доступ нельзя
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    Iterator begin() noexcept {
+        return data_;
+    }
+
+    Iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    void PushBack(const Type& item) {
+        RequireWritable();
+        if (size_ == capacity_) {
+            // item может лежать в отображении, которое переедет при росте
+            Type copy = item;
+            Grow(GrowthPolicy::NextCapacity(capacity_, size_ + 1, sizeof(Type)));
+            data_[size_] = copy;
+        } else {
+            data_[size_] = item;
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    // Новые записи заполняются нулями, как дописанный ftruncate хвост файла
+    void Resize(size_t new_size) {
+        RequireWritable();
+        if (new_size > capacity_) {
+            Grow(GrowthPolicy::NextCapacity(capacity_, new_size, sizeof(Type)));
+        }
+        if (new_size > size_) {
+            std::fill(data_ + size_, data_ + new_size, Type{});
+        }
+        size_ = new_size;
+    }
+
+    void Reserve(size_t new_capacity) {
+        RequireWritable();
+        if (new_capacity > capacity_) {
+            Grow(new_capacity);
+        }
+    }
+
+    // Асинхронно сбрасывает изменённые страницы в файл
+    void Flush() {
+        if (data_ != nullptr && ::msync(data_, capacity_ * sizeof(Type), MS_ASYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+    // Обрезает файл до размера и дожидается записи данных на диск. Ёмкость становится
+    // равной размеру; адреса записей не меняются
+    void Sync() {
+        if (IsOpen() && mode_ == MappingMode::kReadWrite) {
+            Truncate();
+        }
+        if (data_ != nullptr && ::msync(data_, capacity_ * sizeof(Type), MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+        if (IsOpen() && mode_ == MappingMode::kReadWrite && ::fsync(fd_) != 0) {
+            ThrowSystemError("fsync");
+        }
+    }
+
+    // Обрезает файл до размера и закрывает его. Вектор закрывается и при ошибке, но она
+    // выбрасывается как std::system_error: тогда в файле могли остаться лишние записи
+    void Close() {
+        if (int error = Release(); error != 0) {
+            throw std::system_error(error, std::generic_category(), "MappedSimpleVector::Close");
+        }
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    // Длина файла в записях. Обычно равна ёмкости, но после неудачного роста может быть больше
+    size_t file_size_ = 0;
+    int fd_ = -1;
+    MappingMode mode_ = MappingMode::kReadWrite;
+
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void RequireWritable() const {
+        if (!IsOpen() || mode_ != MappingMode::kReadWrite) {
+            throw std::logic_error("MappedSimpleVector is not open for writing");
+        }
+    }
+
+    void Map(size_t capacity) {
+        if (capacity == 0) {
+            return;
+        }
+        data_ = MapFile(capacity);
+        capacity_ = capacity;
+    }
+
+    Type* MapFile(size_t capacity) const {
+        int protection = mode_ == MappingMode::kReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* mapped = ::mmap(nullptr, capacity * sizeof(Type), protection, MAP_SHARED, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        return static_cast<Type*>(mapped);
+    }
+
+    // Снимает отображение с хвоста за size_ и обрезает файл до size_ записей. Отображение
+    // снимается первым: обращение к страницам за концом файла дало бы SIGBUS
+    void Truncate() {
+        const size_t length = size_ * sizeof(Type);
+        if (size_ == 0 && data_ != nullptr) {
+            ::munmap(data_, capacity_ * sizeof(Type));
+            data_ = nullptr;
+        } else if (size_ != capacity_) {
+            const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t kept = (length + page_size - 1) / page_size * page_size;
+            const size_t mapped = (capacity_ * sizeof(Type) + page_size - 1) / page_size * page_size;
+            if (kept < mapped) {
+                ::munmap(reinterpret_cast<char*>(data_) + kept, mapped - kept);
+            }
+        }
+        capacity_ = size_;
+        if (file_size_ != size_) {
+            if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+                ThrowSystemError("ftruncate");
+            }
+            file_size_ = size_;
+        }
+    }
+
+    // Обрезает файл, снимает отображение и закрывает файл. Возвращает код первой ошибки или 0
+    int Release() noexcept {
+        int error = 0;
+        if (IsOpen() && mode_ == MappingMode::kReadWrite) {
+            try {
+                Truncate();
+            } catch (const std::system_error& e) {
+                error = e.code().value();
+            }
+        }
+        if (data_ != nullptr) {
+            ::munmap(data_, capacity_ * sizeof(Type));
+            data_ = nullptr;
+        }
+        if (IsOpen()) {
+            if (::close(fd_) != 0 && error == 0) {
+                error = errno;
+            }
+            fd_ = -1;
+        }
+        size_ = 0;
+        capacity_ = 0;
+        file_size_ = 0;
+        return error;
+    }
+
+    // Удлиняет файл и переотображает его. Содержимое переносить не нужно: оно уже в файле.
+    // Если переотобразить не удалось, файл возвращается к прежней длине
+    void Grow(size_t new_capacity) {
+        assert(new_capacity > capacity_);
+        if (new_capacity > static_cast<size_t>(std::numeric_limits<off_t>::max()) / sizeof(Type)) {
+            throw std::length_error("MappedSimpleVector is too large");
+        }
+        if (::ftruncate(fd_, static_cast<off_t>(new_capacity * sizeof(Type))) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+        file_size_ = new_capacity;
+        try {
+            Remap(new_capacity);
+        } catch (...) {
+            // Если и это не удалось, file_size_ остаётся больше ёмкости, и файл обрежет
+            // Truncate при Sync или Close
+            if (::ftruncate(fd_, static_cast<off_t>(capacity_ * sizeof(Type))) == 0) {
+                file_size_ = capacity_;
+            }
+            throw;
+        }
+    }
+
+    void Remap(size_t new_capacity) {
+        if (data_ == nullptr) {
+            Map(new_capacity);
+            return;
+        }
+#ifdef __linux__
+        void* mapped = ::mremap(data_, capacity_ * sizeof(Type), new_capacity * sizeof(Type), MREMAP_MAYMOVE);
+        if (mapped == MAP_FAILED) {
+            ThrowSystemError("mremap");
+        }
+        data_ = static_cast<Type*>(mapped);
+        capacity_ = new_capacity;
+#else
+        // Новое отображение создаётся до снятия старого: при ошибке вектор остаётся прежним
+        Type* mapped = MapFile(new_capacity);
+        ::munmap(data_, capacity_ * sizeof(Type));
+        data_ = mapped;
+        capacity_ = new_capacity;
+#endif
+    }
+};
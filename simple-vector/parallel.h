@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Политика параллельного выполнения для объёмных операций SimpleVector: заполнения,
+// копирования, Resize и сравнения. Диапазон делится на thread_count кусков, границы которых
+// выровнены по кэш-линиям, чтобы соседние потоки не писали в одну линию. Диапазоны меньше
+// min_elements_per_thread на поток обрабатываются в вызывающем потоке.
+struct ParallelPolicy {
+    size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    size_t min_elements_per_thread = 1 << 15;
+};
+
+inline constexpr size_t kCacheLineSize = 64;
+
+namespace parallel_detail {
+
+// Границы кусков [bounds[i], bounds[i + 1]) для count элементов, начинающихся с адреса base
+inline std::vector<size_t> SplitIntoChunks(const void* base, size_t count, size_t element_size,
+                                           size_t chunk_count) {
+    std::vector<size_t> bounds;
+    bounds.reserve(chunk_count + 1);
+    bounds.push_back(0);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(base);
+    for (size_t i = 1; i < chunk_count; ++i) {
+        size_t bound = count / chunk_count * i;
+        if (kCacheLineSize % element_size == 0) {
+            // Сдвигаем границу вперёд до начала кэш-линии
+            size_t misalignment = (address + bound * element_size) % kCacheLineSize;
+            if (misalignment != 0) {
+                bound += (kCacheLineSize - misalignment) / element_size;
+            }
+        }
+        bounds.push_back(std::clamp(bound, bounds.back(), count));
+    }
+    bounds.push_back(count);
+    return bounds;
+}
+
+}  // namespace parallel_detail
+
+// Вызывает task(chunk_first, chunk_last) для кусков [0, count), по куску на поток, и дожидается
+// всех. Если куски бросили исключения, для каждого успешного куска вызывается
+// rollback(chunk_first, chunk_last), после чего пробрасывается первое исключение.
+template <typename Task, typename Rollback>
+void ParallelFor(const ParallelPolicy& policy, const void* base, size_t count, size_t element_size, Task task,
+                 Rollback rollback) {
+    size_t chunk_count = std::min(policy.thread_count, count / std::max<size_t>(policy.min_elements_per_thread, 1));
+    if (chunk_count <= 1) {
+        task(size_t{0}, count);
+        return;
+    }
+
+    std::vector<size_t> bounds = parallel_detail::SplitIntoChunks(base, count, element_size, chunk_count);
+    std::vector<std::exception_ptr> errors(chunk_count);
+    auto run_chunk = [&](size_t chunk) {
+        try {
+            task(bounds[chunk], bounds[chunk + 1]);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunk_count - 1);
+    try {
+        for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+            workers.emplace_back(run_chunk, chunk);
+        }
+    } catch (...) {
+        // Не удалось создать поток: оставшиеся куски выполняем сами
+        for (size_t chunk = workers.size() + 1; chunk < chunk_count; ++chunk) {
+            run_chunk(chunk);
+        }
+    }
+    run_chunk(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    auto first_error = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+        return error != nullptr;
+    });
+    if (first_error != errors.end()) {
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            if (errors[chunk] == nullptr) {
+                rollback(bounds[chunk], bounds[chunk + 1]);
+            }
+        }
+        std::rethrow_exception(*first_error);
+    }
+}
+
+template <typename Task>
+void ParallelFor(const ParallelPolicy& policy, const void* base, size_t count, size_t element_size, Task task) {
+    ParallelFor(policy, base, count, element_size, task, [](size_t, size_t) {});
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "array_ptr.h"
+#include "constexpr_support.h"
+
+// Тип тривиально перемещаем, если перенос объекта побайтовым копированием с последующим
+// "забыванием" исходника эквивалентен перемещению и разрушению исходника.
+// Для собственных типов (например, владеющих unique_ptr) можно добавить специализацию:
+//     template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {};
+
+template <typename Type>
+inline constexpr bool kIsTriviallyRelocatable = IsTriviallyRelocatable<Type>::value;
+
+// Переносит count объектов из src в неинициализированную память dest, диапазоны не перекрываются.
+// После вызова src содержит сырую память. Тривиально перемещаемые объекты переносятся
+// побайтово, в обход construct/destroy аллокатора, остальные — перемещением, если оно не бросает
+// исключений, иначе копированием: при исключении src не меняется.
+// При вычислении на этапе компиляции побайтовый перенос недоступен, и тривиально перемещаемые
+// объекты переносятся, как остальные; так же устроены функции сдвига ниже.
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedRelocate(Allocator& alloc, Type* src, size_t count, Type* dest) {
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(Type));
+            }
+            return;
+        }
+    }
+    UninitializedMoveIfNoexceptN(alloc, src, count, dest);
+    DestroyN(alloc, src, count);
+}
+
+// Сдвиг объектов внутри одного буфера, диапазоны могут перекрываться.
+// Только для тривиально перемещаемых типов: никогда не бросает исключений.
+template <typename Type>
+void RelocateOverlapping(Type* src, size_t count, Type* dest) noexcept {
+    static_assert(kIsTriviallyRelocatable<Type>);
+    if (count != 0) {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(Type));
+    }
+}
+
+// Создаёт новый элемент на позиции offset буфера [first, first + size), сдвигая хвост вправо.
+// За последним элементом должен быть свободный слот; размер увеличивает вызывающий.
+template <typename Allocator, typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR void EmplaceShifting(Allocator& alloc, Type* first, size_t size, size_t offset,
+                                             Args&&... args) {
+    Type* position = first + offset;
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            // Временный объект живёт в сырой памяти и переносится в освободившийся слот побайтово
+            alignas(Type) unsigned char temp[sizeof(Type)];
+            Type* temp_ptr = reinterpret_cast<Type*>(temp);
+            ConstructAt(alloc, temp_ptr, std::forward<Args>(args)...);
+            RelocateOverlapping(position, size - offset, position + 1);
+            UninitializedRelocate(alloc, temp_ptr, 1, position);
+            return;
+        }
+    }
+    // Аргументы могут ссылаться на сдвигаемые элементы, поэтому сначала создаём временный объект
+    Type temp(std::forward<Args>(args)...);
+    ConstructAt(alloc, first + size, std::move(first[size - 1]));
+    try {
+        std::move_backward(position, first + size - 1, first + size);
+        *position = std::move(temp);
+    } catch (...) {
+        DestroyAt(alloc, first + size);
+        throw;
+    }
+}
+
+// Переносит size элементов из src в новый буфер dest, оставляя на позиции offset место под count
+// элементов, которые создаёт construct_gap(dest + offset). Новые элементы создаются первыми:
+// они могут ссылаться на элементы src. construct_gap при исключении сам разрушает созданное.
+// При успехе src содержит сырую память; при исключении src не меняется, dest пуст (кроме
+// некопируемых типов с бросающим перемещением: для них гарантия только базовая).
+template <typename Allocator, typename Type, typename ConstructGap>
+SIMPLE_VECTOR_CONSTEXPR void InsertRelocating(Allocator& alloc, Type* src, size_t size, size_t offset, size_t count,
+                                              Type* dest, ConstructGap construct_gap) {
+    Type* gap = dest + offset;
+    construct_gap(gap);
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            UninitializedRelocate(alloc, src, offset, dest);
+            UninitializedRelocate(alloc, src + offset, size - offset, gap + count);
+            return;
+        }
+    }
+    try {
+        UninitializedMoveIfNoexceptN(alloc, src, offset, dest);
+        try {
+            UninitializedMoveIfNoexceptN(alloc, src + offset, size - offset, gap + count);
+        } catch (...) {
+            DestroyN(alloc, dest, offset);
+            throw;
+        }
+    } catch (...) {
+        DestroyN(alloc, gap, count);
+        throw;
+    }
+    DestroyN(alloc, src, size);
+}
+
+template <typename Allocator, typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR void EmplaceRelocating(Allocator& alloc, Type* src, size_t size, size_t offset, Type* dest, Args&&... args) {
+    InsertRelocating(alloc, src, size, offset, 1, dest, [&](Type* gap) {
+        ConstructAt(alloc, gap, std::forward<Args>(args)...);
+    });
+}
+
+// Вставляет count элементов, создаваемых construct_gap(ptr), на позицию offset буфера
+// [first, first + size), за которым есть не менее count свободных слотов; размер увеличивает
+// вызывающий. Для тривиально перемещаемых типов хвост сдвигается одним memmove, и construct_gap
+// получает адрес дыры; для остальных новые элементы создаются в конце и переставляются на место
+// одним std::rotate. Вставляемые значения не должны ссылаться на элементы [first + offset, first + size).
+template <typename Allocator, typename Type, typename ConstructGap>
+SIMPLE_VECTOR_CONSTEXPR void InsertShifting(Allocator& alloc, Type* first, size_t size, size_t offset, size_t count,
+                                            ConstructGap construct_gap) {
+    Type* position = first + offset;
+    Type* last = first + size;
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            RelocateOverlapping(position, size - offset, position + count);
+            try {
+                construct_gap(position);
+            } catch (...) {
+                RelocateOverlapping(position + count, size - offset, position);
+                throw;
+            }
+            return;
+        }
+    }
+    construct_gap(last);
+    try {
+        std::rotate(position, last, last + count);
+    } catch (...) {
+        DestroyN(alloc, last, count);
+        throw;
+    }
+}
+
+// Удаляет элемент offset из [first, first + size), сдвигая хвост влево; размер уменьшает вызывающий.
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void EraseShifting(Allocator& alloc, Type* first, size_t size, size_t offset) {
+    Type* position = first + offset;
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            DestroyAt(alloc, position);
+            RelocateOverlapping(position + 1, size - offset - 1, position);
+            return;
+        }
+    }
+    std::move(position + 1, first + size, position);
+    DestroyAt(alloc, first + size - 1);
+}
+
+// Удаляет count элементов начиная с offset из [first, first + size) одним сдвигом хвоста;
+// размер уменьшает вызывающий.
+template <typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void EraseRangeShifting(Allocator& alloc, Type* first, size_t size, size_t offset,
+                                                size_t count) {
+    Type* position = first + offset;
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (!IsConstantEvaluated()) {
+            DestroyN(alloc, position, count);
+            RelocateOverlapping(position + count, size - offset - count, position);
+            return;
+        }
+    }
+    std::move(position + count, first + size, position);
+    DestroyN(alloc, first + size - count, count);
+}
+
+template <typename It>
+inline constexpr bool kIsForwardIterator =
+    std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+// Отсекает перегрузки с итераторами от перегрузок вида (size_t count, const Type& value)
+template <typename It>
+using RequireInputIterator = std::enable_if_t<
+    std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>>;
@@ -0,0 +1,494 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <variant>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+// Двоичное сохранение и загрузка SimpleVector в поток или файловый дескриптор.
+//
+// Формат: 20-байтный заголовок, затем элементы.
+//     magic "SVEC" | version: u16 | endianness: u8 | reserved: u8 | element_size: u32 | size: u64
+// Поля заголовка всегда little-endian, элементы записаны в порядке байт машины, указанном
+// в endianness. Порядок байт и размер элемента проверяются при загрузке.
+//
+// Тривиально копируемые элементы пишутся и читаются одним блоком; для остальных типов нужна
+// специализация Serializer<Type>. Размерам из входа загрузка не доверяет: если длина входа
+// известна, они проверяются по ней, иначе память растёт порциями по мере чтения.
+
+class SerializationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline constexpr uint16_t kSerializationVersion = 1;
+
+namespace serialization_detail {
+
+inline constexpr char kMagic[4] = {'S', 'V', 'E', 'C'};
+inline constexpr size_t kHeaderSize = 20;
+inline constexpr uint8_t kLittleEndian = 1;
+inline constexpr uint8_t kBigEndian = 2;
+
+// Длина непрочитанной части входа неизвестна: канал, сокет, поток без позиционирования
+inline constexpr size_t kUnknownLength = std::numeric_limits<size_t>::max();
+
+// Порция чтения, когда длина входа неизвестна
+inline constexpr size_t kUntrustedChunkBytes = size_t{1} << 16;
+
+inline uint8_t NativeEndianness() noexcept {
+    const uint16_t one = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &one, 1);
+    return first_byte == 1 ? kLittleEndian : kBigEndian;
+}
+
+inline void PutLittleEndian(unsigned char* out, uint64_t value, size_t bytes) noexcept {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+inline uint64_t GetLittleEndian(const unsigned char* in, size_t bytes) noexcept {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+class StreamSink {
+public:
+    explicit StreamSink(std::ostream& output) noexcept : output_(output) {}
+
+    void Write(const void* data, size_t bytes) {
+        if (bytes != 0 && !output_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes))) {
+            throw SerializationError("Failed to write to stream");
+        }
+    }
+
+private:
+    std::ostream& output_;
+};
+
+class StreamSource {
+public:
+    explicit StreamSource(std::istream& input) noexcept : input_(input) {}
+
+    void Read(void* data, size_t bytes) {
+        if (bytes != 0 && !input_.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes))) {
+            throw SerializationError("Unexpected end of stream");
+        }
+        if (remaining_ != kUnknownLength) {
+            remaining_ -= std::min(remaining_, bytes);
+        }
+    }
+
+    // Длина измеряется переходом в конец потока один раз, дальше считается по прочитанному
+    size_t GetRemaining() {
+        if (!measured_) {
+            measured_ = true;
+            const std::streampos current = input_.tellg();
+            if (current == std::streampos(-1)) {
+                return remaining_;
+            }
+            input_.seekg(0, std::ios::end);
+            const std::streampos end = input_.tellg();
+            input_.clear();
+            input_.seekg(current);
+            if (end != std::streampos(-1) && end >= current) {
+                remaining_ = static_cast<size_t>(end - current);
+            }
+        }
+        return remaining_;
+    }
+
+private:
+    std::istream& input_;
+    bool measured_ = false;
+    size_t remaining_ = kUnknownLength;
+};
+
+class FdSink {
+public:
+    explicit FdSink(int fd) noexcept : fd_(fd) {}
+
+    void Write(const void* data, size_t bytes) {
+        const char* first = static_cast<const char*>(data);
+        while (bytes != 0) {
+            ssize_t written = ::write(fd_, first, bytes);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            first += written;
+            bytes -= static_cast<size_t>(written);
+        }
+    }
+
+private:
+    int fd_;
+};
+
+class FdSource {
+public:
+    explicit FdSource(int fd) noexcept : fd_(fd) {}
+
+    void Read(void* data, size_t bytes) {
+        char* first = static_cast<char*>(data);
+        while (bytes != 0) {
+            ssize_t received = ::read(fd_, first, bytes);
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+            if (received == 0) {
+                throw SerializationError("Unexpected end of file");
+            }
+            first += received;
+            bytes -= static_cast<size_t>(received);
+            if (remaining_ != kUnknownLength) {
+                remaining_ -= std::min(remaining_, static_cast<size_t>(received));
+            }
+        }
+    }
+
+    // Длина известна только для обычного файла и измеряется один раз
+    size_t GetRemaining() {
+        if (!measured_) {
+            measured_ = true;
+            struct stat file_stat;
+            if (::fstat(fd_, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+                const off_t position = ::lseek(fd_, 0, SEEK_CUR);
+                if (position >= 0 && file_stat.st_size >= position) {
+                    remaining_ = static_cast<size_t>(file_stat.st_size - position);
+                }
+            }
+        }
+        return remaining_;
+    }
+
+private:
+    int fd_;
+    bool measured_ = false;
+    size_t remaining_ = kUnknownLength;
+};
+
+// true, если во входе есть bytes байт; false, если длина входа неизвестна.
+// Бросает SerializationError, если вход заведомо короче
+template <typename Source>
+bool IsAvailable(Source& source, uint64_t bytes) {
+    const size_t remaining = source.GetRemaining();
+    if (remaining == kUnknownLength) {
+        return false;
+    }
+    if (bytes > remaining) {
+        throw SerializationError("Serialized size exceeds the input");
+    }
+    return true;
+}
+
+}  // namespace serialization_detail
+
+// Запись и чтение одного элемента. Sink::Write(const void*, size_t) и
+// Source::Read(void*, size_t) пишут и читают ровно указанное число байт или бросают исключение.
+// Source::GetRemaining() возвращает число оставшихся байт или kUnknownLength
+template <typename Type>
+struct Serializer {
+    static_assert(std::is_trivially_copyable_v<Type>,
+                  "Specialize Serializer for types that are not trivially copyable");
+
+    template <typename Sink>
+    static void Write(Sink& sink, const Type& value) {
+        sink.Write(&value, sizeof(Type));
+    }
+
+    template <typename Source>
+    static Type Read(Source& source) {
+        Type value;
+        source.Read(&value, sizeof(Type));
+        return value;
+    }
+};
+
+// Строка: длина u64, затем символы
+template <>
+struct Serializer<std::string> {
+    template <typename Sink>
+    static void Write(Sink& sink, const std::string& value) {
+        const uint64_t length = value.size();
+        sink.Write(&length, sizeof(length));
+        sink.Write(value.data(), value.size());
+    }
+
+    template <typename Source>
+    static std::string Read(Source& source) {
+        uint64_t length;
+        source.Read(&length, sizeof(length));
+        std::string value;
+        if (length > value.max_size()) {
+            throw SerializationError("Serialized string is too long");
+        }
+        if (serialization_detail::IsAvailable(source, length)) {
+            value.resize(static_cast<size_t>(length));
+            source.Read(value.data(), value.size());
+            return value;
+        }
+        while (value.size() < length) {
+            const size_t read = value.size();
+            value.resize(read + std::min<size_t>(static_cast<size_t>(length) - read,
+                                                 serialization_detail::kUntrustedChunkBytes));
+            source.Read(value.data() + read, value.size() - read);
+        }
+        return value;
+    }
+};
+
+template <typename Type>
+inline constexpr bool kIsBulkSerializable = std::is_trivially_copyable_v<Type>;
+
+// Размер элемента в заголовке. У типов с Serializer размер записи переменный: пишется 0
+template <typename Type>
+inline constexpr size_t kSerializedElementSize = kIsBulkSerializable<Type> ? sizeof(Type) : 0;
+
+namespace serialization_detail {
+
+template <typename Type, typename Sink>
+void WriteHeader(Sink& sink, size_t size) {
+    unsigned char header[kHeaderSize] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    PutLittleEndian(header + 4, kSerializationVersion, 2);
+    header[6] = NativeEndianness();
+    PutLittleEndian(header + 8, kSerializedElementSize<Type>, 4);
+    PutLittleEndian(header + 12, size, 8);
+    sink.Write(header, kHeaderSize);
+}
+
+// Проверяет заголовок и возвращает число элементов
+template <typename Type, typename Source>
+size_t ReadHeader(Source& source) {
+    unsigned char header[kHeaderSize];
+    source.Read(header, kHeaderSize);
+    if (std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        throw SerializationError("Not a serialized SimpleVector");
+    }
+    if (GetLittleEndian(header + 4, 2) != kSerializationVersion) {
+        throw SerializationError("Unsupported serialization version");
+    }
+    if (header[6] != NativeEndianness()) {
+        throw SerializationError("Data was saved with a different byte order");
+    }
+    if (GetLittleEndian(header + 8, 4) != kSerializedElementSize<Type>) {
+        throw SerializationError("Element size does not match");
+    }
+    uint64_t size = GetLittleEndian(header + 12, 8);
+    if (size > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+        throw SerializationError("Serialized size is too large");
+    }
+    return static_cast<size_t>(size);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Sink>
+void SaveTo(const SimpleVector<Type, Allocator, GrowthPolicy>& vector, Sink& sink) {
+    WriteHeader<Type>(sink, vector.GetSize());
+    if constexpr (kIsBulkSerializable<Type>) {
+        sink.Write(vector.begin(), vector.GetSize() * sizeof(Type));
+    } else {
+        for (const Type& value : vector) {
+            Serializer<Type>::Write(sink, value);
+        }
+    }
+}
+
+// Сколько элементов можно зарезервировать заранее, не доверяя size из заголовка: все, если
+// вход их вмещает (запись элемента — хотя бы байт), иначе одну порцию
+template <typename Type, typename Source>
+size_t TrustedReserve(Source& source, size_t size) {
+    const size_t remaining = source.GetRemaining();
+    if (remaining != kUnknownLength) {
+        return std::min(size, remaining);
+    }
+    return std::min(size, std::max<size_t>(1, kUntrustedChunkBytes / sizeof(Type)));
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Source>
+void LoadFrom(SimpleVector<Type, Allocator, GrowthPolicy>& vector, Source& source) {
+    const size_t size = ReadHeader<Type>(source);
+    if constexpr (kIsBulkSerializable<Type>) {
+        if (!IsAvailable(source, uint64_t{size} * sizeof(Type))) {
+            // Длина входа неизвестна: вектор растёт порциями, пока данные действительно есть
+            constexpr size_t kChunk = std::max<size_t>(1, kUntrustedChunkBytes / sizeof(Type));
+            ArrayPtr<Type> chunk(std::min(size, kChunk));
+            SimpleVector<Type, Allocator, GrowthPolicy> loaded(vector.GetAllocator());
+            for (size_t done = 0; done < size;) {
+                const size_t part = std::min(size - done, kChunk);
+                source.Read(chunk.Get(), part * sizeof(Type));
+                loaded.Append(chunk.Get(), chunk.Get() + part);
+                done += part;
+            }
+            vector.swap(loaded);
+            return;
+        }
+        // Читаем прямо в новый буфер и отдаём его вектору без копирования
+        using AllocTraits = std::allocator_traits<Allocator>;
+        Allocator alloc = vector.GetAllocator();
+        Type* data = size == 0 ? nullptr : AllocTraits::allocate(alloc, size);
+        try {
+            source.Read(data, size * sizeof(Type));
+        } catch (...) {
+            if (data != nullptr) {
+                AllocTraits::deallocate(alloc, data, size);
+            }
+            throw;
+        }
+        vector.Adopt(data, size, size);
+    } else {
+        SimpleVector<Type, Allocator, GrowthPolicy> loaded(vector.GetAllocator());
+        loaded.Reserve(TrustedReserve<Type>(source, size));
+        for (size_t i = 0; i < size; ++i) {
+            loaded.EmplaceBack(Serializer<Type>::Read(source));
+        }
+        vector.swap(loaded);
+    }
+}
+
+}  // namespace serialization_detail
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Save(const SimpleVector<Type, Allocator, GrowthPolicy>& vector, std::ostream& output) {
+    serialization_detail::StreamSink sink(output);
+    serialization_detail::SaveTo(vector, sink);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Save(const SimpleVector<Type, Allocator, GrowthPolicy>& vector, int fd) {
+    serialization_detail::FdSink sink(fd);
+    serialization_detail::SaveTo(vector, sink);
+}
+
+// Заменяет содержимое vector загруженным. При ошибке vector не меняется
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Load(SimpleVector<Type, Allocator, GrowthPolicy>& vector, std::istream& input) {
+    serialization_detail::StreamSource source(input);
+    serialization_detail::LoadFrom(vector, source);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Load(SimpleVector<Type, Allocator, GrowthPolicy>& vector, int fd) {
+    serialization_detail::FdSource source(fd);
+    serialization_detail::LoadFrom(vector, source);
+}
+
+// Читает сохранённый вектор из потока или файлового дескриптора порциями по chunk_size
+// элементов. Если длина входа известна, ёмкость резервируется один раз по заголовку и за время
+// загрузки вектор не реаллоцируется; иначе он растёт по мере чтения. В памяти помимо вектора
+// живёт не больше одной порции
+template <typename Type>
+class SimpleVectorReader {
+public:
+    static constexpr size_t kDefaultChunkSize = std::max<size_t>(1, (size_t{1} << 16) / sizeof(Type));
+
+    explicit SimpleVectorReader(std::istream& input) : source_(serialization_detail::StreamSource(input)) {
+        ReadHeader();
+    }
+
+    // Дескриптор читается с текущей позиции и остаётся во владении вызывающего
+    explicit SimpleVectorReader(int fd) : source_(serialization_detail::FdSource(fd)) {
+        ReadHeader();
+    }
+
+    // Число элементов по заголовку
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetRemaining() const noexcept {
+        return remaining_;
+    }
+
+    // Дописывает в vector до max_count следующих элементов и возвращает их число (0 в конце).
+    // При первом вызове резервирует место под все оставшиеся элементы
+    template <typename Allocator, typename GrowthPolicy>
+    size_t ReadChunk(SimpleVector<Type, Allocator, GrowthPolicy>& vector, size_t max_count) {
+        std::visit([&](auto& source) { Reserve(source, vector); }, source_);
+        const size_t count = std::min(max_count, remaining_);
+        std::visit([&](auto& source) { Read(source, vector, count); }, source_);
+        remaining_ -= count;
+        return count;
+    }
+
+    // Дочитывает все оставшиеся элементы
+    template <typename Allocator, typename GrowthPolicy>
+    void ReadAll(SimpleVector<Type, Allocator, GrowthPolicy>& vector, size_t chunk_size = kDefaultChunkSize) {
+        while (ReadChunk(vector, chunk_size) != 0) {
+        }
+    }
+
+private:
+    std::variant<serialization_detail::StreamSource, serialization_detail::FdSource> source_;
+    size_t size_ = 0;
+    size_t remaining_ = 0;
+    // Буфер порции для тривиально копируемых типов
+    ArrayPtr<Type> chunk_;
+
+    void ReadHeader() {
+        remaining_ = size_ = std::visit([](auto& source) { return serialization_detail::ReadHeader<Type>(source); },
+                                        source_);
+        if constexpr (kIsBulkSerializable<Type>) {
+            std::visit([&](auto& source) { serialization_detail::IsAvailable(source, uint64_t{size_} * sizeof(Type)); },
+                       source_);
+        }
+    }
+
+    template <typename Source, typename Allocator, typename GrowthPolicy>
+    // Если длина входа известна, резервирует место под все оставшиеся элементы (на деле один
+    // раз). Иначе вектор растёт по своей политике в Append и EmplaceBack: точный Reserve на
+    // каждую порцию сделал бы рост линейным, а копирование — квадратичным
+    void Reserve(Source& source, SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+        if (source.GetRemaining() == serialization_detail::kUnknownLength) {
+            return;
+        }
+        const size_t wanted = serialization_detail::TrustedReserve<Type>(source, remaining_);
+        if (vector.GetCapacity() < vector.GetSize() + wanted) {
+            vector.Reserve(vector.GetSize() + wanted);
+        }
+    }
+
+    template <typename Source, typename Allocator, typename GrowthPolicy>
+    void Read(Source& source, SimpleVector<Type, Allocator, GrowthPolicy>& vector, size_t count) {
+        if constexpr (kIsBulkSerializable<Type>) {
+            if (!chunk_) {
+                chunk_ = ArrayPtr<Type>(kDefaultChunkSize);
+            }
+            for (size_t done = 0; done < count;) {
+                size_t part = std::min(count - done, kDefaultChunkSize);
+                source.Read(chunk_.Get(), part * sizeof(Type));
+                vector.Append(chunk_.Get(), chunk_.Get() + part);
+                done += part;
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                vector.EmplaceBack(Serializer<Type>::Read(source));
+            }
+        }
+    }
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "constexpr_support.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Векторизованные поиск и сравнение для арифметических типов. Ядро ISA сравнивает блок
+// из kBlockBytes байт и возвращает маску, в которой каждому байту равной пары элементов
+// соответствует kBitsPerByte установленных бит. Без SIMD используются алгоритмы std.
+
+namespace simd_detail {
+
+#if defined(__AVX2__)
+
+inline constexpr bool kHasSimd = true;
+inline constexpr size_t kBlockBytes = 32;
+inline constexpr unsigned kBitsPerByte = 1;
+using Mask = uint64_t;
+
+template <typename Type>
+__m256i Load(const Type* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+template <typename Type>
+Mask EqualMask(__m256i lhs, __m256i rhs) {
+    __m256i equal;
+    if constexpr (std::is_same_v<Type, float>) {
+        equal = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(lhs), _mm256_castsi256_ps(rhs), _CMP_EQ_OQ));
+    } else if constexpr (std::is_same_v<Type, double>) {
+        equal = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(lhs), _mm256_castsi256_pd(rhs), _CMP_EQ_OQ));
+    } else if constexpr (sizeof(Type) == 1) {
+        equal = _mm256_cmpeq_epi8(lhs, rhs);
+    } else if constexpr (sizeof(Type) == 2) {
+        equal = _mm256_cmpeq_epi16(lhs, rhs);
+    } else if constexpr (sizeof(Type) == 4) {
+        equal = _mm256_cmpeq_epi32(lhs, rhs);
+    } else {
+        equal = _mm256_cmpeq_epi64(lhs, rhs);
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, const Type* rhs) {
+    return EqualMask<Type>(Load(lhs), Load(rhs));
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, Type value) {
+    __m256i splat;
+    if constexpr (sizeof(Type) == 1) {
+        splat = _mm256_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(Type) == 2) {
+        splat = _mm256_set1_epi16(static_cast<short>(value));
+    } else if constexpr (std::is_same_v<Type, float>) {
+        splat = _mm256_castps_si256(_mm256_set1_ps(value));
+    } else if constexpr (std::is_same_v<Type, double>) {
+        splat = _mm256_castpd_si256(_mm256_set1_pd(value));
+    } else if constexpr (sizeof(Type) == 4) {
+        splat = _mm256_set1_epi32(static_cast<int>(value));
+    } else {
+        splat = _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+    return EqualMask<Type>(Load(lhs), splat);
+}
+
+#elif defined(__SSE2__)
+
+inline constexpr bool kHasSimd = true;
+inline constexpr size_t kBlockBytes = 16;
+inline constexpr unsigned kBitsPerByte = 1;
+using Mask = uint64_t;
+
+template <typename Type>
+__m128i Load(const Type* ptr) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+template <typename Type>
+Mask EqualMask(__m128i lhs, __m128i rhs) {
+    __m128i equal;
+    if constexpr (std::is_same_v<Type, float>) {
+        equal = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(lhs), _mm_castsi128_ps(rhs)));
+    } else if constexpr (std::is_same_v<Type, double>) {
+        equal = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(lhs), _mm_castsi128_pd(rhs)));
+    } else if constexpr (sizeof(Type) == 1) {
+        equal = _mm_cmpeq_epi8(lhs, rhs);
+    } else if constexpr (sizeof(Type) == 2) {
+        equal = _mm_cmpeq_epi16(lhs, rhs);
+    } else if constexpr (sizeof(Type) == 4) {
+        equal = _mm_cmpeq_epi32(lhs, rhs);
+    } else {
+        // В SSE2 нет сравнения 64-битных слов: обе половины слова должны совпасть
+        __m128i equal32 = _mm_cmpeq_epi32(lhs, rhs);
+        equal = _mm_and_si128(equal32, _mm_shuffle_epi32(equal32, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(equal));
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, const Type* rhs) {
+    return EqualMask<Type>(Load(lhs), Load(rhs));
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, Type value) {
+    __m128i splat;
+    if constexpr (sizeof(Type) == 1) {
+        splat = _mm_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(Type) == 2) {
+        splat = _mm_set1_epi16(static_cast<short>(value));
+    } else if constexpr (std::is_same_v<Type, float>) {
+        splat = _mm_castps_si128(_mm_set1_ps(value));
+    } else if constexpr (std::is_same_v<Type, double>) {
+        splat = _mm_castpd_si128(_mm_set1_pd(value));
+    } else if constexpr (sizeof(Type) == 4) {
+        splat = _mm_set1_epi32(static_cast<int>(value));
+    } else {
+        splat = _mm_set1_epi64x(static_cast<long long>(value));
+    }
+    return EqualMask<Type>(Load(lhs), splat);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+inline constexpr bool kHasSimd = true;
+inline constexpr size_t kBlockBytes = 16;
+// Маска строится сужением 16 байт сравнения до 64 бит: по 4 бита на байт
+inline constexpr unsigned kBitsPerByte = 4;
+using Mask = uint64_t;
+
+template <typename Type>
+uint8x16_t Load(const Type* ptr) {
+    return vld1q_u8(reinterpret_cast<const uint8_t*>(ptr));
+}
+
+template <typename Type>
+Mask EqualMask(uint8x16_t lhs, uint8x16_t rhs) {
+    uint8x16_t equal;
+    if constexpr (std::is_same_v<Type, float>) {
+        equal = vreinterpretq_u8_u32(vceqq_f32(vreinterpretq_f32_u8(lhs), vreinterpretq_f32_u8(rhs)));
+    } else if constexpr (std::is_same_v<Type, double>) {
+        equal = vreinterpretq_u8_u64(vceqq_f64(vreinterpretq_f64_u8(lhs), vreinterpretq_f64_u8(rhs)));
+    } else if constexpr (sizeof(Type) == 1) {
+        equal = vceqq_u8(lhs, rhs);
+    } else if constexpr (sizeof(Type) == 2) {
+        equal = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(lhs), vreinterpretq_u16_u8(rhs)));
+    } else if constexpr (sizeof(Type) == 4) {
+        equal = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(lhs), vreinterpretq_u32_u8(rhs)));
+    } else {
+        equal = vreinterpretq_u8_u64(vceqq_u64(vreinterpretq_u64_u8(lhs), vreinterpretq_u64_u8(rhs)));
+    }
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, const Type* rhs) {
+    return EqualMask<Type>(Load(lhs), Load(rhs));
+}
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, Type value) {
+    Type splat[kBlockBytes / sizeof(Type)];
+    std::fill(std::begin(splat), std::end(splat), value);
+    return EqualMask<Type>(Load(lhs), Load(splat));
+}
+
+#else
+
+inline constexpr bool kHasSimd = false;
+// Только объявления: ветки с ними отбрасываются if constexpr
+inline constexpr size_t kBlockBytes = 8;
+inline constexpr unsigned kBitsPerByte = 1;
+using Mask = uint64_t;
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, const Type* rhs);
+
+template <typename Type>
+Mask EqualMask(const Type* lhs, Type value);
+
+#endif
+
+}  // namespace simd_detail
+
+// Тип поддерживается векторными ядрами: целые и числа с плавающей точкой размером 1–8 байт
+template <typename Type>
+inline constexpr bool kIsSimdSearchable =
+    simd_detail::kHasSimd && std::is_arithmetic_v<Type> &&
+    (std::is_integral_v<Type> || std::is_same_v<Type, float> || std::is_same_v<Type, double>) &&
+    (sizeof(Type) == 1 || sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8);
+
+// Индекс первого элемента, равного value, или size
+template <typename Type>
+size_t SimdFind(const Type* data, size_t size, const Type& value) {
+    size_t i = 0;
+    if constexpr (kIsSimdSearchable<Type>) {
+        using namespace simd_detail;
+        constexpr size_t kLanes = kBlockBytes / sizeof(Type);
+        for (; i + kLanes <= size; i += kLanes) {
+            if (Mask mask = EqualMask(data + i, value)) {
+                return i + __builtin_ctzll(mask) / (kBitsPerByte * sizeof(Type));
+            }
+        }
+    }
+    return std::find(data + i, data + size, value) - data;
+}
+
+template <typename Type>
+size_t SimdCount(const Type* data, size_t size, const Type& value) {
+    size_t i = 0;
+    size_t count = 0;
+    if constexpr (kIsSimdSearchable<Type>) {
+        using namespace simd_detail;
+        constexpr size_t kLanes = kBlockBytes / sizeof(Type);
+        for (; i + kLanes <= size; i += kLanes) {
+            count += __builtin_popcountll(EqualMask(data + i, value));
+        }
+        count /= kBitsPerByte * sizeof(Type);
+    }
+    return count + std::count(data + i, data + size, value);
+}
+
+// Индекс первой позиции, где lhs[i] != rhs[i], или size
+template <typename Type>
+size_t SimdMismatch(const Type* lhs, const Type* rhs, size_t size) {
+    size_t i = 0;
+    if constexpr (kIsSimdSearchable<Type>) {
+        using namespace simd_detail;
+        constexpr size_t kLanes = kBlockBytes / sizeof(Type);
+        constexpr Mask kAllEqual = kBlockBytes * kBitsPerByte == 64 ? ~Mask{0}
+                                                                    : (Mask{1} << (kBlockBytes * kBitsPerByte)) - 1;
+        for (; i + kLanes <= size; i += kLanes) {
+            if (Mask different = ~EqualMask(lhs + i, rhs + i) & kAllEqual) {
+                return i + __builtin_ctzll(different) / (kBitsPerByte * sizeof(Type));
+            }
+        }
+    }
+    return std::mismatch(lhs + i, lhs + size, rhs + i).first - lhs;
+}
+
+// Сравнение диапазонов для операторов контейнеров: сначала размеры, затем для целых
+// memcmp, для float/double — векторное поэлементное сравнение, иначе (и при вычислении на этапе
+// компиляции) std::equal
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool RangesEqual(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    if (lhs_size != rhs_size) {
+        return false;
+    }
+    if (IsConstantEvaluated()) {
+        return std::equal(lhs, lhs + lhs_size, rhs);
+    }
+    if constexpr (std::is_integral_v<Type>) {
+        return lhs_size == 0 || std::memcmp(lhs, rhs, lhs_size * sizeof(Type)) == 0;
+    } else if constexpr (kIsSimdSearchable<Type>) {
+        return SimdMismatch(lhs, rhs, lhs_size) == lhs_size;
+    } else {
+        return std::equal(lhs, lhs + lhs_size, rhs);
+    }
+}
+
+// Лексикографическое сравнение. Для целых первая отличающаяся позиция ищется векторно;
+// для чисел с плавающей точкой это неверно из-за NaN, поэтому они идут через std
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool RangesLess(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    if (IsConstantEvaluated()) {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);
+    }
+    if constexpr (std::is_integral_v<Type> && kIsSimdSearchable<Type>) {
+        size_t common_size = std::min(lhs_size, rhs_size);
+        size_t position = SimdMismatch(lhs, rhs, common_size);
+        if (position != common_size) {
+            return lhs[position] < rhs[position];
+        }
+        return lhs_size < rhs_size;
+    } else {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);
+    }
+}
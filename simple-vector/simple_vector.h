@@ -1,308 +1,404 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <stdexcept>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
 
+#include "aligned_allocator.h"
 #include "array_ptr.h"
+#include "constexpr_support.h"
+#include "growth_policy.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "simd.h"
+#include "simple_vector_base.h"
+#include "simple_vector_view.h"
+#include "vector_stats.h"
 
 struct ReserveProxyObject {
     size_t capacity_to_reserve;
-    explicit ReserveProxyObject(size_t capacity) : capacity_to_reserve(capacity) {}
+    constexpr explicit ReserveProxyObject(size_t capacity) : capacity_to_reserve(capacity) {}
 };
 
-ReserveProxyObject Reserve(size_t capacity_to_reserve) {
+constexpr ReserveProxyObject Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObject(capacity_to_reserve);
 }
 
+// Буфер SimpleVector вне вектора: size живых элементов в памяти под capacity элементов
 template <typename Type>
-class SimpleVector {
-public:
-    using Iterator = Type*;
-    using ConstIterator = const Type*;
+struct SimpleVectorBuffer {
+    Type* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
 
-    SimpleVector() noexcept = default;
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SimpleVector : public SimpleVectorBase<SimpleVector<Type, Allocator, GrowthPolicy>, Type, Allocator, GrowthPolicy> {
+    using Base = SimpleVectorBase<SimpleVector, Type, Allocator, GrowthPolicy>;
+    using typename Base::AllocTraits;
+    using typename Base::Storage;
 
-    explicit SimpleVector(size_t size) : size_(size), capacity_(size), data_(size) {
-        std::fill(data_.Get(), data_.Get() + size_, Type());
-    }
+    friend Base;
 
-    SimpleVector(size_t size, const Type& value) : size_(size), capacity_(size), data_(size) {
-        std::fill(data_.Get(), data_.Get() + size_, value);
-    }
+public:
+    using typename Base::Iterator;
+    using typename Base::ConstIterator;
+    using typename Base::AllocatorType;
 
-    SimpleVector(std::initializer_list<Type> init) : size_(init.size()), capacity_(init.size()), data_(init.size()) {
-        std::copy(init.begin(), init.end(), data_.Get());
-    }
+    using Base::begin;
+    using Base::end;
+    using Base::Clear;
+    using Base::GetCapacity;
+    using Base::Reserve;
 
-    size_t GetSize() const noexcept {
-        return size_;
-    }
+    SimpleVector() noexcept(noexcept(Allocator())) = default;
 
-    size_t GetCapacity() const noexcept {
-        return capacity_;
-    }
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Allocator& alloc) noexcept : Base(alloc) {}
 
-    bool IsEmpty() const noexcept {
-        return size_ == 0;
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : Base(size, alloc) {
+        UninitializedValueConstructN(data_.GetAllocator(), data_.Get(), size);
+        size_ = size;
     }
 
-    Type& operator[](size_t index) noexcept {
-        assert(index < size_);
-        return data_[index];
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : Base(size, alloc) {
+        UninitializedFillN(data_.GetAllocator(), data_.Get(), size, value);
+        size_ = size;
     }
 
-    const Type& operator[](size_t index) const noexcept {
-        assert(index < size_);
-        return data_[index];
+    // Параллельные варианты конструкторов: элементы создаются кусками в нескольких потоках
+    SimpleVector(const ParallelPolicy& policy, size_t size, const Allocator& alloc = Allocator())
+        : Base(size, alloc) {
+        ParallelConstruct(policy, 0, size, [this](Type* first, size_t, size_t count) {
+            UninitializedValueConstructN(data_.GetAllocator(), first, count);
+        });
+        size_ = size;
     }
 
-    Type& At(size_t index) {
-        if (index >= size_) {
-            throw std::out_of_range("Index out of range");
-        }
-        return data_[index];
+    SimpleVector(const ParallelPolicy& policy, size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : Base(size, alloc) {
+        ParallelConstruct(policy, 0, size, [this, &value](Type* first, size_t, size_t count) {
+            UninitializedFillN(data_.GetAllocator(), first, count, value);
+        });
+        size_ = size;
     }
 
-    const Type& At(size_t index) const {
-        if (index >= size_) {
-            throw std::out_of_range("Index out of range");
-        }
-        return data_[index];
+    SimpleVector(const ParallelPolicy& policy, const SimpleVector& other)
+        : Base(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+        ParallelConstruct(policy, 0, other.size_, [this, &other](Type* first, size_t index, size_t count) {
+            UninitializedCopy(data_.GetAllocator(), other.begin() + index, other.begin() + index + count, first);
+        });
+        size_ = other.size_;
     }
 
-    void Clear() noexcept {
-        size_ = 0;
-    }
-
-    void Resize(size_t new_size) {
-        if (new_size <= size_) {
-            size_ = new_size;
-        } else if (new_size <= capacity_) {
-            for (size_t i = size_; i < new_size; ++i) {
-                data_[i] = Type();
-            }
-            size_ = new_size;
-        } else {  // new_size > capacity
-            int new_capacity = std::max(new_size, capacity_ * 2);
-
-            ArrayPtr<Type> new_array(new_capacity);
-            for (size_t i = 0; i < size_; ++i) {
-                new_array[i] = std::move(data_[i]);
-            }
-            for (size_t i = size_; i < new_size; ++i) {
-                new_array[i] = Type();
-            }
-
-            data_.swap(new_array);
-            capacity_ = new_capacity;
-            size_ = new_size;
-        }
-    }
-
-    Iterator begin() noexcept {
-        return data_.Get();
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : Base(init.size(), alloc) {
+        UninitializedCopy(data_.GetAllocator(), init.begin(), init.end(), data_.Get());
+        size_ = init.size();
     }
 
-    Iterator end() noexcept {
-        return data_.Get() + size_;
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(ReserveProxyObject wrapper, const Allocator& alloc = Allocator())
+        : Base(alloc) {
+        Reserve(wrapper.capacity_to_reserve);
     }
 
-    ConstIterator begin() const noexcept {
-        return data_.Get();
-    }
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {}
 
-    ConstIterator end() const noexcept {
-        return data_.Get() + size_;
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other, const Allocator& alloc)
+        : Base(other.size_, alloc) {
+        UninitializedCopy(data_.GetAllocator(), other.begin(), other.end(), data_.Get());
+        size_ = other.size_;
     }
 
-    ConstIterator cbegin() const noexcept {
-        return data_.Get();
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other) noexcept : Base(std::move(other)) {
+        other.InvalidateViews();
     }
 
-    ConstIterator cend() const noexcept {
-        return data_.Get() + size_;
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other, const Allocator& alloc) : Base(alloc) {
+        if (data_.GetAllocator() == other.data_.GetAllocator()) {
+            Storage stolen(std::move(other.data_));
+            data_.swap(stolen);
+            size_ = std::exchange(other.size_, 0);
+            other.InvalidateViews();
+        } else {
+            // Память другого аллокатора нельзя присвоить: переносим элементы по одному
+            Storage new_data(other.size_, alloc);
+            UninitializedMoveN(new_data.GetAllocator(), other.data_.Get(), other.size_, new_data.Get());
+            data_.swap(new_data);
+            size_ = other.size_;
+        }
     }
 
-    SimpleVector(const SimpleVector& other) {
-        SimpleVector<Type> cp(other.size_);
-        std::copy(other.begin(), other.end(), cp.begin());
-
-        size_ = cp.size_;
-        capacity_ = cp.capacity_;
-        data_.swap(cp.data_);
+    SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+        DestroyN(data_.GetAllocator(), data_.Get(), size_);
     }
 
-    SimpleVector(SimpleVector&& other) noexcept
-        : size_(std::exchange(other.size_, 0)),
-          capacity_(std::exchange(other.capacity_, 0)),
-          data_(std::move(other.data_)) {}
-
-    SimpleVector& operator=(const SimpleVector& rhs) {
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(const SimpleVector& rhs) {
         if (this != &rhs) {
-            auto temp(rhs);
-            swap(temp);
+            this->CopyAssign(rhs);
         }
         return *this;
     }
 
-    SimpleVector& operator=(SimpleVector&& other) noexcept {
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(SimpleVector&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
         if (this != &other) {
-            size_ = std::exchange(other.size_, 0);
-            capacity_ = std::exchange(other.capacity_, 0);
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value) {
+                if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                    SimpleVector temp(std::move(other), data_.GetAllocator());
+                    swap(temp);
+                    return *this;
+                }
+            }
+            Clear();
             data_ = std::move(other.data_);
+            size_ = std::exchange(other.size_, 0);
+            InvalidateViews();
+            other.InvalidateViews();
         }
         return *this;
     }
 
-    explicit SimpleVector(ReserveProxyObject wrapper) {
-        capacity_ = wrapper.capacity_to_reserve;
-        Reserve(capacity_);
-    }
-
-    void PushBack(const Type& value) {
-        size_t new_size = size_ + 1;
-        if (new_size > capacity_) {
-            size_t new_capacity = (capacity_ != 0) ? std::max(new_size, 2 * capacity_) : 1;
-            ReallocateAndMoveData(new_capacity);
+    void Resize(const ParallelPolicy& policy, size_t new_size) {
+        if (new_size <= size_) {
+            this->Resize(new_size);
+            return;
         }
-        data_[size_] = value;
+        if (new_size > GetCapacity()) {
+            this->ReallocateAndMoveData(this->GrowCapacity(new_size), new_size);
+        }
+        ParallelConstruct(policy, size_, new_size - size_, [this](Type* first, size_t, size_t count) {
+            UninitializedValueConstructN(data_.GetAllocator(), first, count);
+        });
         size_ = new_size;
     }
 
-    void PushBack(Type&& value) {
-        size_t new_size = size_ + 1;
-        if (new_size > capacity_) {
-            size_t new_capacity = (capacity_ != 0) ? std::max(new_size, 2 * capacity_) : 1;
-            ReallocateAndMoveData(new_capacity);
-        }
-        data_[size_] = std::move(value);
-        size_ = new_size;
+    using Base::Resize;
+
+    SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector& other) noexcept {
+        std::swap(size_, other.size_);
+        data_.swap(other.data_);
+        InvalidateViews();
+        other.InvalidateViews();
     }
 
-    Iterator Insert(ConstIterator position, const Type& value) {
-        assert(position >= begin() && position <= end());
+    // Принимает буфер без копирования: в data уже живут size элементов, места хватает на
+    // capacity. Буфер должен быть выделен аллокатором этого вектора (например, получен из Detach)
+    SIMPLE_VECTOR_CONSTEXPR void Adopt(Type* data, size_t size, size_t capacity) noexcept {
+        assert(size <= capacity && (data != nullptr || capacity == 0));
+        Clear();
+        data_ = Storage(data, capacity, data_.GetAllocator());
+        size_ = size;
+        InvalidateViews();
+    }
 
-        int position_offset = position - data_.Get();
-        Iterator element_position = data_.Get() + position_offset;
+    SIMPLE_VECTOR_CONSTEXPR void Adopt(SimpleVectorBuffer<Type> buffer) noexcept {
+        Adopt(buffer.data, buffer.size, buffer.capacity);
+    }
 
-        size_t new_size = size_ + 1;
-        if (new_size <= capacity_) {
-            std::copy_backward(element_position, data_.Get() + size_, data_.Get() + size_ + 1u);
-            data_[position_offset] = value;
-        } else {
-            size_t new_capacity = (capacity_ != 0) ? std::max(new_size, 2u * capacity_) : 1;
+    // То же для чужого буфера: вектор освободит его вызовом deleter(data), в том числе при
+    // реаллокации. Элементы перед этим разрушаются через аллокатор вектора. При исключении
+    // буфер остаётся во владении вызывающего
+    template <typename Deleter>
+    void Adopt(Type* data, size_t size, size_t capacity, Deleter deleter) {
+        assert(size <= capacity && (data != nullptr || capacity == 0));
+        Storage adopted(data, capacity, std::move(deleter), data_.GetAllocator());
+        Clear();
+        data_ = std::move(adopted);
+        size_ = size;
+        InvalidateViews();
+    }
 
-            ArrayPtr<Type> new_data(new_capacity);
-            std::copy(data_.Get(), element_position, new_data.Get());
-            new_data[position_offset] = value;
-            std::copy(element_position, data_.Get() + size_, new_data.Get() + position_offset + 1u);
+    // Отдаёт буфер вместе с живыми элементами и оставляет вектор пустым. Вызывающий сам
+    // разрушает элементы и освобождает память аллокатором вектора. Буфер, принятый через
+    // Adopt с deleter, возвращается без вызова deleter — освобождать его надо тем же способом
+    [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR SimpleVectorBuffer<Type> Detach() noexcept {
+        SimpleVectorBuffer<Type> buffer{data_.Get(), size_, GetCapacity()};
+        (void)data_.Release();
+        size_ = 0;
+        InvalidateViews();
+        return buffer;
+    }
 
-            data_.swap(new_data);
+    // Буфер принят через Adopt с deleter и ещё не заменён при реаллокации
+    SIMPLE_VECTOR_CONSTEXPR bool IsExternal() const noexcept {
+        return data_.IsExternal();
+    }
 
-            capacity_ = new_capacity;
+    // Уменьшает ёмкость до max(new_capacity, GetSize()); ёмкость никогда не растёт
+    SIMPLE_VECTOR_CONSTEXPR void ShrinkTo(size_t new_capacity) {
+        new_capacity = this->RoundCapacity(std::max(new_capacity, size_));
+        if (new_capacity >= GetCapacity()) {
+            return;
         }
-        size_ = new_size;
+        if (new_capacity == 0) {
+            data_ = Storage(data_.GetAllocator());
+            InvalidateViews();
+        } else {
+            this->ReallocateAndMoveData(new_capacity);
+        }
+    }
 
-        return data_.Get() + position_offset;
+    // Вид на все элементы; вектор и сам неявно приводится к виду
+    SimpleVectorView<Type> View() noexcept {
+        return SimpleVectorView<Type>(data_.Get(), size_, GetGeneration());
     }
 
-    Iterator Insert(ConstIterator position, Type&& value) {
-        assert(position >= begin() && position <= end());
+    SimpleVectorView<const Type> View() const noexcept {
+        return SimpleVectorView<const Type>(data_.Get(), size_, GetGeneration());
+    }
 
-        int position_offset = position - data_.Get();
-        Iterator element_position = data_.Get() + position_offset;
+    operator SimpleVectorView<Type>() noexcept {
+        return View();
+    }
 
-        size_t new_size = size_ + 1;
-        if (new_size <= capacity_) {
-            std::move_backward(element_position, data_.Get() + size_, data_.Get() + size_ + 1u);
-            data_[position_offset] = std::move(value);
-        } else {
-            size_t new_capacity = (capacity_ != 0) ? std::max(new_size, 2u * capacity_) : 1;
+    operator SimpleVectorView<const Type>() const noexcept {
+        return View();
+    }
 
-            ArrayPtr<Type> new_data(new_capacity);
-            std::move(data_.Get(), element_position, new_data.Get());
-            new_data[position_offset] = std::move(value);
-            std::move(element_position, data_.Get() + size_, new_data.Get() + position_offset + 1u);
+    // Вид на count элементов начиная с offset, без копирования
+    SimpleVectorView<Type> Slice(size_t offset, size_t count) {
+        return View().Slice(offset, count);
+    }
 
-            data_.swap(new_data);
-            capacity_ = new_capacity;
-        }
-        size_ = new_size;
+    SimpleVectorView<const Type> Slice(size_t offset, size_t count) const {
+        return View().Slice(offset, count);
+    }
 
-        return data_.Get() + position_offset;
+private:
+    using Base::size_;
+    using Base::data_;
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+    // Номер поколения буфера, по которому виды узнают о его замене
+    size_t generation_ = 0;
+#endif
+
+    SIMPLE_VECTOR_CONSTEXPR Type* BufferData() noexcept {
+        return data_.Get();
     }
 
-    void PopBack() noexcept {
-        assert(size_ != 0);
-        --size_;
+    SIMPLE_VECTOR_CONSTEXPR const Type* BufferData() const noexcept {
+        return data_.Get();
     }
-    
-    Iterator Erase(ConstIterator pos) {
-        assert(pos >= begin() && pos < end());
 
-        size_t erase_index = pos - cbegin();
-        Iterator new_first = &(data_[erase_index]);
-        std::move(begin() + erase_index + 1, end(), new_first);
-        --size_;
-        return begin() + erase_index;
+    SIMPLE_VECTOR_CONSTEXPR size_t BufferCapacity() const noexcept {
+        return data_.GetCapacity();
     }
 
-    void swap(SimpleVector& other) noexcept {
-        std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
-        data_.swap(other.data_);
+    SIMPLE_VECTOR_CONSTEXPR void InvalidateViews() noexcept {
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+        ++generation_;
+#endif
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity > capacity_) {
-            ReallocateAndMoveData(new_capacity);
-        }
+    const size_t* GetGeneration() const noexcept {
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+        return &generation_;
+#else
+        return nullptr;
+#endif
     }
 
-private:
-    size_t size_ = 0;
-    size_t capacity_ = 0;
-    ArrayPtr<Type> data_;
-
-    void ReallocateAndMoveData(size_t new_capacity) {
-        ArrayPtr<Type> new_data(new_capacity);
-        size_t elements_count = std::min(size_, new_capacity);
-        for (size_t i = 0; i < elements_count; ++i) {
-            new_data[i] = std::move(data_[i]);
-        }
-        data_.swap(new_data);
-        capacity_ = new_capacity;
+    // Создаёт элементы [offset, offset + count) кусками в нескольких потоках:
+    // construct(first, index, chunk_size) создаёт chunk_size элементов начиная с first,
+    // index — номер первого из них относительно offset. При исключении созданное разрушается
+    template <typename ConstructChunk>
+    void ParallelConstruct(const ParallelPolicy& policy, size_t offset, size_t count, ConstructChunk construct) {
+        Allocator& alloc = data_.GetAllocator();
+        Type* first = data_.Get() + offset;
+        ParallelFor(
+            policy, first, count, sizeof(Type),
+            [&](size_t chunk_first, size_t chunk_last) {
+                construct(first + chunk_first, chunk_first, chunk_last - chunk_first);
+            },
+            [&](size_t chunk_first, size_t chunk_last) {
+                DestroyN(alloc, first + chunk_first, chunk_last - chunk_first);
+            });
     }
 };
 
-template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
-}
+// Вектор с данными, выровненными по Alignment байт (по умолчанию по кэш-линии), и ёмкостью,
+// кратной Alignment байт: begin() годится для выровненных SIMD-загрузок, а буферы разных
+// потоков не делят кэш-линий
+template <typename Type, size_t Alignment = kCacheLineSize>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>, PaddedGrowth<DoublingGrowth, Alignment>>;
 
-template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(lhs == rhs);
-}
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); 
+// Копирует элементы в std::array ровно из Size элементов. Вектор, построенный при компиляции,
+// не может пережить вычисление, а массив может: так таблица попадает в .rodata
+template <size_t Size, typename Type, typename Allocator, typename GrowthPolicy>
+constexpr std::array<Type, Size> ToArray(const SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+    if (vector.GetSize() != Size) {
+        throw std::length_error("Vector size does not match array size");
+    }
+    std::array<Type, Size> result{};
+    std::copy(vector.begin(), vector.end(), result.begin());
+    return result;
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(rhs < lhs);
+// То же для вектора, который строит функция без аргументов Build: размер массива берётся
+// из первого её вызова, поэтому его не нужно указывать вручную.
+//     constexpr auto kTable = ToArray<BuildTable>();
+template <auto Build>
+consteval auto ToArray() {
+    constexpr size_t size = Build().GetSize();
+    return ToArray<size>(Build());
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return rhs < lhs;
+#endif  // SIMPLE_VECTOR_HAS_CONSTEXPR
+
+// Параллельные варианты сравнения для очень больших векторов
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool Equal(const ParallelPolicy& policy, const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+           const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    // Куски проверяются блоками, чтобы прекратить работу, как только другой поток нашёл различие
+    constexpr size_t kBlockSize = 1 << 12;
+    std::atomic<bool> equal{true};
+    ParallelFor(policy, lhs.begin(), lhs.GetSize(), sizeof(Type), [&](size_t first, size_t last) {
+        for (size_t block = first; block < last && equal.load(std::memory_order_relaxed); block += kBlockSize) {
+            size_t block_last = std::min(last, block + kBlockSize);
+            size_t block_size = block_last - block;
+            if (!RangesEqual(lhs.begin() + block, block_size, rhs.begin() + block, block_size)) {
+                equal.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+    return equal.load();
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return !(lhs < rhs);
-} 
\ No newline at end of file
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool Less(const ParallelPolicy& policy, const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+          const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    // Ищем первую позицию, где элементы не эквивалентны: она и решает исход сравнения
+    const size_t common_size = std::min(lhs.GetSize(), rhs.GetSize());
+    std::atomic<size_t> mismatch{common_size};
+    ParallelFor(policy, lhs.begin(), common_size, sizeof(Type), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last && i < mismatch.load(std::memory_order_relaxed); ++i) {
+            if (lhs[i] < rhs[i] || rhs[i] < lhs[i]) {
+                size_t current = mismatch.load(std::memory_order_relaxed);
+                while (i < current && !mismatch.compare_exchange_weak(current, i, std::memory_order_relaxed)) {
+                }
+                break;
+            }
+        }
+    });
+    size_t position = mismatch.load();
+    if (position != common_size) {
+        return lhs[position] < rhs[position];
+    }
+    return lhs.GetSize() < rhs.GetSize();
+}
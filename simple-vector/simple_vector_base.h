@@ -0,0 +1,561 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "constexpr_support.h"
+#include "growth_policy.h"
+#include "relocation.h"
+#include "simd.h"
+#include "vector_stats.h"
+
+// Общая часть SimpleVector и SmallSimpleVector: размер, буфер в куче и все операции над
+// элементами. Наследник (CRTP) сообщает, где сейчас лежат элементы, и определяет, как буфер
+// ужимается:
+//     Type* BufferData() noexcept;  const Type* BufferData() const noexcept;
+//     size_t BufferCapacity() const noexcept;
+//     void ShrinkTo(size_t new_capacity);
+// Может определить InvalidateViews(), которая вызывается при каждой замене буфера.
+// Конструкторы, перемещение и обмен остаются за наследником: они зависят от того, где лежат элементы.
+template <typename Derived, typename Type, typename Allocator, typename GrowthPolicy>
+class SimpleVectorBase {
+protected:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Storage = ArrayPtr<Type, Allocator>;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using AllocatorType = Allocator;
+
+    SIMPLE_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+        return Self().BufferCapacity();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return begin()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return begin()[index];
+    }
+
+    // Поиск значения; для арифметических типов векторизован
+    Iterator Find(const Type& value) {
+        return begin() + SimdFind(static_cast<const Type*>(begin()), GetSize(), value);
+    }
+
+    ConstIterator Find(const Type& value) const {
+        return begin() + SimdFind(begin(), GetSize(), value);
+    }
+
+    size_t Count(const Type& value) const {
+        return SimdCount(begin(), GetSize(), value);
+    }
+
+    bool Contains(const Type& value) const {
+        return Find(value) != end();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+        DestroyN(data_.GetAllocator(), begin(), size_);
+        size_ = 0;
+        MaybeShrink();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyN(data_.GetAllocator(), begin() + new_size, size_ - new_size);
+            size_ = new_size;
+            RecordVectorSize(GetCapacity(), size_);
+            MaybeShrink();
+            return;
+        }
+        if (new_size > GetCapacity()) {
+            ReallocateAndMoveData(GrowCapacity(new_size), new_size);
+        }
+        UninitializedValueConstructN(data_.GetAllocator(), end(), new_size - size_);
+        size_ = new_size;
+    }
+
+    // Новые элементы — копии value; value может быть элементом этого же вектора
+    SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size, const Type& value) {
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        Insert(end(), new_size - size_, value);
+    }
+
+    // Изменяет размер, не инициализируя новые элементы: их содержимое не определено, пока
+    // его не запишут (например, read() или вычислительное ядро). Только для тривиальных типов
+    SIMPLE_VECTOR_CONSTEXPR void ResizeUninitialized(size_t new_size) {
+        static_assert(std::is_trivially_default_constructible_v<Type> && std::is_trivially_destructible_v<Type>,
+                      "ResizeUninitialized requires a trivial type");
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        if (new_size > GetCapacity()) {
+            ReallocateAndMoveData(GrowCapacity(new_size), new_size);
+        }
+        size_ = new_size;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
+        return Self().BufferData();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
+        return begin() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
+        return Self().BufferData();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
+        return begin() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type& value) {
+        EmplaceBack(value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator position, const Type& value) {
+        return Emplace(position, value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator position, Type&& value) {
+        return Emplace(position, std::move(value));
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator position, size_t count, const Type& value) {
+        assert(position >= begin() && position <= end());
+
+        Allocator& alloc = data_.GetAllocator();
+        auto fill = [&](const Type& filler) {
+            return InsertGap(position - cbegin(), count, [&](Type* gap) {
+                UninitializedFillN(alloc, gap, count, filler);
+            });
+        };
+        // Сдвиг хвоста испортил бы значение, если оно лежит в самом векторе. При вычислении на этапе
+        // компиляции адреса разных объектов несравнимы, поэтому там копия делается всегда
+        const Type* value_ptr = std::addressof(value);
+        if (IsConstantEvaluated() || (value_ptr >= cbegin() && value_ptr < cend())) {
+            Type copy(value);
+            return fill(copy);
+        }
+        return fill(value);
+    }
+
+    // Диапазон [first, last) не должен указывать на элементы самого вектора.
+    // Для forward-итераторов размер считается заранее: не более одной реаллокации и один сдвиг хвоста
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator position, InputIt first, InputIt last) {
+        assert(position >= begin() && position <= end());
+
+        size_t position_offset = position - cbegin();
+        if constexpr (kIsForwardIterator<InputIt>) {
+            Allocator& alloc = data_.GetAllocator();
+            size_t count = std::distance(first, last);
+            return InsertGap(position_offset, count, [&](Type* gap) {
+                UninitializedCopy(alloc, first, last, gap);
+            });
+        } else {
+            size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + position_offset, begin() + old_size, end());
+            return begin() + position_offset;
+        }
+    }
+
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    SIMPLE_VECTOR_CONSTEXPR void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    SIMPLE_VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+        if constexpr (kIsForwardIterator<InputIt>) {
+            Allocator& alloc = data_.GetAllocator();
+            size_t count = std::distance(first, last);
+            if (count > GetCapacity()) {
+                Storage new_data(RoundCapacity(count), alloc);
+                RecordVectorReallocation(this, sizeof(Type), GetCapacity(), new_data.GetCapacity(), 0, count);
+                UninitializedCopy(alloc, first, last, new_data.Get());
+                Clear();
+                data_.swap(new_data);
+                Self().InvalidateViews();
+            } else if (count <= size_) {
+                Iterator new_end = std::copy(first, last, begin());
+                DestroyN(alloc, new_end, end() - new_end);
+            } else {
+                InputIt middle = std::next(first, size_);
+                std::copy(first, middle, begin());
+                UninitializedCopy(alloc, middle, last, end());
+            }
+            size_ = count;
+        } else {
+            Clear();
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            EmplaceReallocating(size_, std::forward<Args>(args)...);
+        } else {
+            ConstructAt(data_.GetAllocator(), end(), std::forward<Args>(args)...);
+            ++size_;
+        }
+        return begin()[size_ - 1];
+    }
+
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator position, Args&&... args) {
+        assert(position >= begin() && position <= end());
+
+        size_t position_offset = position - cbegin();
+        if (position_offset == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        } else if (size_ < GetCapacity()) {
+            RecordVectorShift(this, sizeof(Type), GetCapacity(), size_ + 1, size_ - position_offset);
+            EmplaceShifting(data_.GetAllocator(), begin(), size_, position_offset, std::forward<Args>(args)...);
+            ++size_;
+        } else {
+            EmplaceReallocating(position_offset, std::forward<Args>(args)...);
+        }
+        return begin() + position_offset;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyAt(data_.GetAllocator(), begin() + size_);
+        RecordVectorSize(GetCapacity(), size_);
+        MaybeShrink();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+
+        size_t erase_index = pos - cbegin();
+        RecordVectorShift(this, sizeof(Type), GetCapacity(), size_ - 1, size_ - erase_index - 1);
+        EraseShifting(data_.GetAllocator(), begin(), size_, erase_index);
+        --size_;
+        MaybeShrink();
+        return begin() + erase_index;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+
+        size_t erase_index = first - cbegin();
+        size_t count = last - first;
+        if (count != 0) {
+            RecordVectorShift(this, sizeof(Type), GetCapacity(), size_ - count, size_ - erase_index - count);
+            EraseRangeShifting(data_.GetAllocator(), begin(), size_, erase_index, count);
+            size_ -= count;
+            MaybeShrink();
+        }
+        return begin() + erase_index;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            ReallocateAndMoveData(RoundCapacity(new_capacity));
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void ShrinkToFit() {
+        Self().ShrinkTo(size_);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator==(const Derived& lhs, const Derived& rhs) {
+        return RangesEqual(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator!=(const Derived& lhs, const Derived& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator<(const Derived& lhs, const Derived& rhs) {
+        return RangesLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator<=(const Derived& lhs, const Derived& rhs) {
+        return !(rhs < lhs);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator>(const Derived& lhs, const Derived& rhs) {
+        return rhs < lhs;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR friend bool operator>=(const Derived& lhs, const Derived& rhs) {
+        return !(lhs < rhs);
+    }
+
+protected:
+    size_t size_ = 0;
+    // Буфер в куче; у SmallSimpleVector пуст, пока элементы во встроенном буфере
+    Storage data_;
+
+    SimpleVectorBase() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVectorBase(const Allocator& alloc) noexcept : data_(alloc) {}
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVectorBase(size_t capacity, const Allocator& alloc)
+        : data_(RoundCapacity(capacity), alloc) {}
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVectorBase(SimpleVectorBase&& other) noexcept
+        : size_(std::exchange(other.size_, 0)),
+          data_(std::move(other.data_)) {}
+
+    SimpleVectorBase(const SimpleVectorBase&) = delete;
+    SimpleVectorBase& operator=(const SimpleVectorBase&) = delete;
+    SimpleVectorBase& operator=(SimpleVectorBase&&) = delete;
+
+    ~SimpleVectorBase() = default;
+
+    // Наследник без видов ничего не отслеживает
+    SIMPLE_VECTOR_CONSTEXPR void InvalidateViews() noexcept {}
+
+    SIMPLE_VECTOR_CONSTEXPR Derived& Self() noexcept {
+        return static_cast<Derived&>(*this);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Derived& Self() const noexcept {
+        return static_cast<const Derived&>(*this);
+    }
+
+    // Копирующее присваивание. Если аллокатор распространяется и меняется, старая память
+    // возвращается старому аллокатору до его замены. Затем rhs копируется в текущий буфер,
+    // если помещается, иначе через временный вектор
+    SIMPLE_VECTOR_CONSTEXPR void CopyAssign(const Derived& rhs) {
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            if (data_.GetAllocator() != rhs.data_.GetAllocator()) {
+                Clear();
+                data_ = Storage(data_.GetAllocator());
+                data_.GetAllocator() = rhs.data_.GetAllocator();
+                Self().InvalidateViews();
+            }
+        }
+        if (!AssignInPlace(rhs)) {
+            Derived temp(rhs, data_.GetAllocator());
+            Self() = std::move(temp);
+        }
+    }
+
+    // Копирующее присваивание в уже выделенный буфер, если в нём помещается rhs: общий префикс
+    // присваивается, недостающие элементы создаются, лишние разрушаются. Обходится без выделения
+    // памяти; при исключении гарантия базовая. Возвращает false, если буфер мал
+    SIMPLE_VECTOR_CONSTEXPR bool AssignInPlace(const Derived& rhs) {
+        if constexpr (std::is_copy_assignable_v<Type>) {
+            if (rhs.size_ > GetCapacity()) {
+                return false;
+            }
+            const size_t common_size = std::min(size_, rhs.size_);
+            std::copy(rhs.begin(), rhs.begin() + common_size, begin());
+            if (rhs.size_ > size_) {
+                UninitializedCopy(data_.GetAllocator(), rhs.begin() + size_, rhs.end(), end());
+                size_ = rhs.size_;
+            } else {
+                DestroyN(data_.GetAllocator(), begin() + rhs.size_, size_ - rhs.size_);
+                size_ = rhs.size_;
+                RecordVectorSize(GetCapacity(), size_);
+                MaybeShrink();
+            }
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Ёмкость под явно заданное число элементов: точно, если политика не округляет
+    static constexpr size_t RoundCapacity(size_t capacity) noexcept {
+        if constexpr (HasRoundPolicy<GrowthPolicy>::value) {
+            return capacity == 0 ? 0 : GrowthPolicy::RoundCapacity(capacity, sizeof(Type));
+        } else {
+            return capacity;
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GrowCapacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type));
+    }
+
+    // Автоматическое сжатие, если его задаёт политика роста. Выполняется, только когда перенос
+    // элементов не бросает исключений; ошибка выделения памяти оставляет буфер прежним.
+    SIMPLE_VECTOR_CONSTEXPR void MaybeShrink() noexcept {
+        if constexpr (HasShrinkPolicy<GrowthPolicy>::value &&
+                      (kIsTriviallyRelocatable<Type> || std::is_nothrow_move_constructible_v<Type>)) {
+            size_t new_capacity = GrowthPolicy::ShrinkCapacity(GetCapacity(), size_, sizeof(Type));
+            if (new_capacity < GetCapacity()) {
+                try {
+                    Self().ShrinkTo(new_capacity);
+                } catch (...) {
+                }
+            }
+        }
+    }
+
+    // Переносит живые элементы в новый буфер кучи на new_capacity элементов. final_size — размер,
+    // который вектор получит по завершении операции (для статистики)
+    SIMPLE_VECTOR_CONSTEXPR void ReallocateAndMoveData(size_t new_capacity, size_t final_size) {
+        assert(new_capacity >= size_);
+        if (TryReallocateInPlace(new_capacity, final_size)) {
+            return;
+        }
+        Storage new_data(new_capacity, data_.GetAllocator());
+        RecordVectorReallocation(this, sizeof(Type), GetCapacity(), new_capacity, size_, final_size);
+        UninitializedRelocate(data_.GetAllocator(), begin(), size_, new_data.Get());
+        data_.swap(new_data);
+        Self().InvalidateViews();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void ReallocateAndMoveData(size_t new_capacity) {
+        ReallocateAndMoveData(new_capacity, size_);
+    }
+
+    // Элементы, переносимые побайтно, могут переехать вместе с блоком, если аллокатор умеет
+    // менять его размер сам (mremap): тогда многогигабайтный буфер растёт без копирования.
+    // Элементы во встроенном буфере так не переносятся: буфера кучи ещё нет
+    SIMPLE_VECTOR_CONSTEXPR bool TryReallocateInPlace(size_t new_capacity, size_t final_size) noexcept {
+        if constexpr (HasReallocate<Allocator>::value && kIsTriviallyRelocatable<Type>) {
+            if (!IsConstantEvaluated() && data_.Get() == begin()) {
+                const size_t old_capacity = GetCapacity();
+                if (data_.TryReallocate(new_capacity)) {
+                    RecordVectorReallocation(this, sizeof(Type), old_capacity, new_capacity, size_, final_size);
+                    Self().InvalidateViews();
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR void EmplaceReallocating(size_t position_offset, Args&&... args) {
+        if constexpr (HasReallocate<Allocator>::value && kIsTriviallyRelocatable<Type>) {
+            // Аргументы могут ссылаться на элементы, поэтому новый элемент создаётся до переезда блока
+            if (position_offset == size_ && !IsConstantEvaluated()) {
+                Type value(std::forward<Args>(args)...);
+                if (TryReallocateInPlace(GrowCapacity(size_ + 1), size_ + 1)) {
+                    ConstructAt(data_.GetAllocator(), begin() + size_, std::move(value));
+                    ++size_;
+                } else {
+                    EmplaceIntoNewBuffer(position_offset, std::move(value));
+                }
+                return;
+            }
+        }
+        EmplaceIntoNewBuffer(position_offset, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR void EmplaceIntoNewBuffer(size_t position_offset, Args&&... args) {
+        Storage new_data(GrowCapacity(size_ + 1), data_.GetAllocator());
+        RecordVectorReallocation(this, sizeof(Type), GetCapacity(), new_data.GetCapacity(), size_, size_ + 1);
+        EmplaceRelocating(data_.GetAllocator(), begin(), size_, position_offset, new_data.Get(),
+                          std::forward<Args>(args)...);
+        data_.swap(new_data);
+        Self().InvalidateViews();
+        ++size_;
+    }
+
+    // Вставляет count элементов на позицию position_offset: construct_gap(ptr) создаёт их по адресу ptr
+    template <typename ConstructGap>
+    SIMPLE_VECTOR_CONSTEXPR Iterator InsertGap(size_t position_offset, size_t count, ConstructGap construct_gap) {
+        if (count == 0) {
+            return begin() + position_offset;
+        }
+        Allocator& alloc = data_.GetAllocator();
+        if (count > GetCapacity() - size_) {
+            if (count > std::numeric_limits<size_t>::max() - size_) {
+                throw std::length_error("Vector size overflow");
+            }
+            Storage new_data(GrowCapacity(size_ + count), alloc);
+            RecordVectorReallocation(this, sizeof(Type), GetCapacity(), new_data.GetCapacity(), size_,
+                                     size_ + count);
+            InsertRelocating(alloc, begin(), size_, position_offset, count, new_data.Get(), construct_gap);
+            data_.swap(new_data);
+            Self().InvalidateViews();
+        } else {
+            RecordVectorShift(this, sizeof(Type), GetCapacity(), size_ + count, size_ - position_offset);
+            InsertShifting(alloc, begin(), size_, position_offset, count, construct_gap);
+        }
+        size_ += count;
+        return begin() + position_offset;
+    }
+};
+
+// Удаляет все элементы, удовлетворяющие pred, за один проход с сохранением порядка остальных.
+// Возвращает число удалённых элементов
+template <typename Derived, typename Type, typename Allocator, typename GrowthPolicy, typename Pred>
+SIMPLE_VECTOR_CONSTEXPR size_t EraseIf(SimpleVectorBase<Derived, Type, Allocator, GrowthPolicy>& vector, Pred pred) {
+    auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    size_t removed = vector.end() - new_end;
+    vector.Erase(new_end, vector.end());
+    return removed;
+}
+
+template <typename Derived, typename Type, typename Allocator, typename GrowthPolicy, typename Value>
+SIMPLE_VECTOR_CONSTEXPR size_t Erase(SimpleVectorBase<Derived, Type, Allocator, GrowthPolicy>& vector,
+                                     const Value& value) {
+    return EraseIf(vector, [&value](const Type& element) {
+        return element == value;
+    });
+}
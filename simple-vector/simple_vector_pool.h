@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+struct SimpleVectorPoolOptions {
+    // Сколько свободных векторов хранит каждый поток
+    size_t max_cached_per_thread = 16;
+    // Векторы большей ёмкости при возврате освобождаются, а не кэшируются
+    size_t max_cached_capacity = std::numeric_limits<size_t>::max();
+    // Раз в trim_interval возвратов поток освобождает векторы, которые за это время ни разу
+    // не понадобились (сколько их пролежало в кэше в самый загруженный момент)
+    size_t trim_interval = 1024;
+};
+
+namespace pool_detail {
+
+// Номера пулов не повторяются, поэтому запись потока об уже разрушенном пуле никогда
+// не спутать с новым пулом по тому же адресу
+inline uint64_t NextPoolId() noexcept {
+    static std::atomic<uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace pool_detail
+
+// Пул векторов, сохраняющих ёмкость между использованиями. Acquire выдаёт пустой вектор из
+// свободного списка текущего потока (или новый, если список пуст), Release очищает вектор
+// без освобождения памяти и кладёт его в список того потока, который вернул вектор. Вектор,
+// разогнанный до рабочего размера, больше не проходит последовательность ростов заново,
+// и конвейер в установившемся режиме не выделяет памяти вовсе.
+//
+// Списки у каждого потока свои, поэтому Acquire и Release не берут блокировок: мьютекс
+// захватывается, только когда поток впервые обращается к пулу. Пул разрушается после того,
+// как все потоки перестали им пользоваться; списки завершившихся потоков живут до разрушения пула,
+// а записи потоков о разрушенных пулах вычищаются при следующем обращении потока к новому пулу.
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SimpleVectorPool {
+    static_assert(!HasShrinkPolicy<GrowthPolicy>::value,
+                  "SimpleVectorPool needs a growth policy without automatic shrinking: Clear would release capacity");
+
+public:
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+
+    explicit SimpleVectorPool(SimpleVectorPoolOptions options = {}, const Allocator& alloc = Allocator())
+        : options_(options),
+          alloc_(alloc) {}
+
+    SimpleVectorPool(const SimpleVectorPool&) = delete;
+    SimpleVectorPool& operator=(const SimpleVectorPool&) = delete;
+
+    Vector Acquire() {
+        ThreadCache& cache = GetThreadCache();
+        if (cache.free.IsEmpty()) {
+            return Vector(alloc_);
+        }
+        Vector vector = std::move(cache.free[cache.free.GetSize() - 1]);
+        cache.free.PopBack();
+        cache.low_water = std::min(cache.low_water, cache.free.GetSize());
+        return vector;
+    }
+
+    // Вектор ёмкостью не меньше min_capacity
+    Vector Acquire(size_t min_capacity) {
+        Vector vector = Acquire();
+        vector.Reserve(min_capacity);
+        return vector;
+    }
+
+    // Возвращает вектор в пул; содержимое разрушается, память остаётся за вектором
+    void Release(Vector&& vector) {
+        ThreadCache& cache = GetThreadCache();
+        if (vector.GetCapacity() != 0 && vector.GetCapacity() <= options_.max_cached_capacity &&
+            cache.free.GetSize() < options_.max_cached_per_thread) {
+            vector.Clear();
+            cache.free.PushBack(std::move(vector));
+        } else {
+            Vector dropped(std::move(vector));
+        }
+        if (++cache.releases >= options_.trim_interval) {
+            TrimIdle(cache);
+        }
+    }
+
+    // Число свободных векторов в списке текущего потока
+    size_t GetCachedCount() {
+        return GetThreadCache().free.GetSize();
+    }
+
+    // Освобождает все свободные векторы текущего потока
+    void Trim() {
+        ThreadCache& cache = GetThreadCache();
+        cache.free.Clear();
+        cache.low_water = 0;
+        cache.releases = 0;
+    }
+
+    // Число пулов этого типа, о которых помнит текущий поток
+    static size_t GetThreadPoolCount() noexcept {
+        return ThreadEntries().GetSize();
+    }
+
+private:
+    struct ThreadCache {
+        SimpleVector<Vector> free;
+        // Наименьший размер списка с последней подрезки: столько векторов лежали без дела
+        size_t low_water = 0;
+        size_t releases = 0;
+    };
+
+    struct CacheEntry {
+        uint64_t pool_id;
+        ThreadCache* cache;
+        // Истекает, когда пул разрушен
+        std::weak_ptr<const char> pool;
+    };
+
+    const uint64_t id_ = pool_detail::NextPoolId();
+    const SimpleVectorPoolOptions options_;
+    const Allocator alloc_;
+    // Живёт столько же, сколько пул; по нему поток узнаёт, что его запись о пуле устарела
+    const std::shared_ptr<const char> token_ = std::make_shared<const char>();
+
+    std::mutex mutex_;
+    SimpleVector<std::unique_ptr<ThreadCache>> caches_;
+
+    // Поток хранит указатели на свои списки во всех пулах этого типа
+    static SimpleVector<CacheEntry>& ThreadEntries() noexcept {
+        thread_local SimpleVector<CacheEntry> entries;
+        return entries;
+    }
+
+    // Обычно пулов единицы, и поиск по последнему использованному находит список сразу.
+    // Новая запись появляется только при промахе, поэтому тогда же удаляются записи
+    // о разрушенных пулах: их число не превышает числа живых пулов
+    ThreadCache& GetThreadCache() {
+        SimpleVector<CacheEntry>& entries = ThreadEntries();
+        for (size_t i = entries.GetSize(); i != 0; --i) {
+            if (entries[i - 1].pool_id == id_) {
+                return *entries[i - 1].cache;
+            }
+        }
+        EraseIf(entries, [](const CacheEntry& entry) {
+            return entry.pool.expired();
+        });
+        auto cache = std::make_unique<ThreadCache>();
+        cache->free.Reserve(options_.max_cached_per_thread);
+        ThreadCache* raw = cache.get();
+        {
+            std::lock_guard guard(mutex_);
+            caches_.PushBack(std::move(cache));
+        }
+        entries.PushBack({id_, raw, token_});
+        return *raw;
+    }
+
+    // Подрезка по нижней отметке: векторы, не понадобившиеся за весь интервал, лишние.
+    // Освобождаются самые давно возвращённые, они в начале списка
+    static void TrimIdle(ThreadCache& cache) noexcept {
+        const size_t idle = std::min(cache.low_water, cache.free.GetSize());
+        if (idle != 0) {
+            cache.free.Erase(cache.free.begin(), cache.free.begin() + idle);
+        }
+        cache.low_water = cache.free.GetSize();
+        cache.releases = 0;
+    }
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include "simd.h"
+
+// Проверка видов на устаревание. Если перед подключением simple_vector.h определён макрос
+// SIMPLE_VECTOR_DEBUG_VIEWS, вектор хранит номер поколения буфера и увеличивает его при каждой
+// замене буфера (реаллокация, ShrinkToFit, swap, перемещение, Adopt, Detach). Вид запоминает
+// адрес счётчика и его значение; обращение к виду после замены буфера прерывает программу
+// через assert. Вектор должен пережить свои виды. Без макроса проверка пустая и ничего не стоит.
+namespace view_detail {
+
+#ifdef SIMPLE_VECTOR_DEBUG_VIEWS
+class GenerationCheck {
+public:
+    GenerationCheck() noexcept = default;
+
+    explicit GenerationCheck(const size_t* generation) noexcept
+        : generation_(generation),
+          expected_(generation != nullptr ? *generation : 0) {}
+
+    bool IsValid() const noexcept {
+        return generation_ == nullptr || *generation_ == expected_;
+    }
+
+private:
+    const size_t* generation_ = nullptr;
+    size_t expected_ = 0;
+};
+#else
+class GenerationCheck {
+public:
+    GenerationCheck() noexcept = default;
+
+    explicit GenerationCheck(const size_t* /*generation*/) noexcept {}
+
+    bool IsValid() const noexcept {
+        return true;
+    }
+};
+#endif
+
+}  // namespace view_detail
+
+// Невладеющий вид на непрерывный участок элементов: указатель и размер. Копируется бесплатно,
+// Slice и Chunk выделяют подучастки без выделения памяти. SimpleVectorView<const Type>
+// даёт доступ только на чтение; неконстантный вид неявно приводится к константному.
+// Вид становится недействительным, когда вектор меняет буфер.
+template <typename Type>
+class SimpleVectorView : private view_detail::GenerationCheck {
+    template <typename Other>
+    using RequireAddsConst = std::enable_if_t<std::is_same_v<const Other, Type> && !std::is_same_v<Other, Type>>;
+
+public:
+    using Iterator = Type*;
+    using ValueType = std::remove_const_t<Type>;
+
+    SimpleVectorView() noexcept = default;
+
+    SimpleVectorView(Type* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    // generation — счётчик поколений вектора (nullptr, если проверка не нужна)
+    SimpleVectorView(Type* data, size_t size, const size_t* generation) noexcept
+        : GenerationCheck(generation),
+          data_(data),
+          size_(size) {}
+
+    template <typename Other, typename = RequireAddsConst<Other>>
+    SimpleVectorView(const SimpleVectorView<Other>& other) noexcept
+        : GenerationCheck(other.GetGenerationCheck()),
+          data_(other.data_),
+          size_(other.size_) {}
+
+    Type* Data() const noexcept {
+        CheckValid();
+        return data_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        CheckValid();
+        return data_[index];
+    }
+
+    Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    Iterator begin() const noexcept {
+        CheckValid();
+        return data_;
+    }
+
+    Iterator end() const noexcept {
+        CheckValid();
+        return data_ + size_;
+    }
+
+    // count элементов начиная с offset
+    SimpleVectorView Slice(size_t offset, size_t count) const {
+        if (offset > size_ || count > size_ - offset) {
+            throw std::out_of_range("Slice is out of range");
+        }
+        return WithRange(offset, count);
+    }
+
+    // Элементы начиная с offset до конца
+    SimpleVectorView Slice(size_t offset) const {
+        if (offset > size_) {
+            throw std::out_of_range("Slice is out of range");
+        }
+        return WithRange(offset, size_ - offset);
+    }
+
+    // Часть index из chunk_count почти равных (размеры отличаются не больше чем на 1):
+    // удобно раздать участки рабочим потокам
+    SimpleVectorView Chunk(size_t index, size_t chunk_count) const {
+        if (chunk_count == 0 || index >= chunk_count) {
+            throw std::out_of_range("Chunk index is out of range");
+        }
+        const size_t base = size_ / chunk_count;
+        const size_t extra = size_ % chunk_count;
+        const size_t offset = index * base + std::min(index, extra);
+        return WithRange(offset, base + (index < extra ? 1 : 0));
+    }
+
+    // Буфер, на который смотрит вид, ещё не заменён
+    bool IsValid() const noexcept {
+        return GenerationCheck::IsValid();
+    }
+
+#ifdef __cpp_lib_span
+    operator std::span<Type>() const noexcept {
+        return std::span<Type>(Data(), size_);
+    }
+#endif
+
+private:
+    template <typename>
+    friend class SimpleVectorView;
+
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+
+    const GenerationCheck& GetGenerationCheck() const noexcept {
+        return *this;
+    }
+
+    void CheckValid() const noexcept {
+        assert(IsValid() && "SimpleVectorView is used after the vector replaced its buffer");
+    }
+
+    SimpleVectorView WithRange(size_t offset, size_t count) const noexcept {
+        CheckValid();
+        SimpleVectorView view = *this;
+        view.data_ = data_ + offset;
+        view.size_ = count;
+        return view;
+    }
+};
+
+template <typename Lhs, typename Rhs,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<Lhs>, std::remove_const_t<Rhs>>>>
+bool operator==(const SimpleVectorView<Lhs>& lhs, const SimpleVectorView<Rhs>& rhs) {
+    return RangesEqual<std::remove_const_t<Lhs>>(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+}
+
+template <typename Lhs, typename Rhs,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<Lhs>, std::remove_const_t<Rhs>>>>
+bool operator!=(const SimpleVectorView<Lhs>& lhs, const SimpleVectorView<Rhs>& rhs) {
+    return !(lhs == rhs);
+}
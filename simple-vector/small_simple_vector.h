@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "relocation.h"
+#include "simple_vector.h"
+#include "simple_vector_base.h"
+
+// Вектор с API SimpleVector, хранящий до N элементов внутри объекта.
+// Память в куче (через ArrayPtr) выделяется только когда элементов становится больше N.
+// Операции над элементами общие с SimpleVector (SimpleVectorBase); здесь только выбор
+// между встроенным буфером и кучей.
+template <typename Type, size_t N, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SmallSimpleVector
+    : public SimpleVectorBase<SmallSimpleVector<Type, N, Allocator, GrowthPolicy>, Type, Allocator, GrowthPolicy> {
+    static_assert(N > 0, "Inline capacity must be positive, use SimpleVector instead");
+
+    using Base = SimpleVectorBase<SmallSimpleVector, Type, Allocator, GrowthPolicy>;
+    using typename Base::AllocTraits;
+    using typename Base::Storage;
+
+    friend Base;
+
+public:
+    using typename Base::Iterator;
+    using typename Base::ConstIterator;
+    using typename Base::AllocatorType;
+
+    using Base::begin;
+    using Base::end;
+    using Base::Clear;
+    using Base::GetCapacity;
+    using Base::Reserve;
+
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallSimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    explicit SmallSimpleVector(const Allocator& alloc) noexcept : Base(alloc) {}
+
+    explicit SmallSimpleVector(size_t size, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Reserve(size);
+        UninitializedValueConstructN(data_.GetAllocator(), begin(), size);
+        size_ = size;
+    }
+
+    SmallSimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Reserve(size);
+        UninitializedFillN(data_.GetAllocator(), begin(), size, value);
+        size_ = size;
+    }
+
+    SmallSimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Reserve(init.size());
+        UninitializedCopy(data_.GetAllocator(), init.begin(), init.end(), begin());
+        size_ = init.size();
+    }
+
+    explicit SmallSimpleVector(ReserveProxyObject wrapper, const Allocator& alloc = Allocator()) : Base(alloc) {
+        Reserve(wrapper.capacity_to_reserve);
+    }
+
+    SmallSimpleVector(const SmallSimpleVector& other)
+        : SmallSimpleVector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {}
+
+    SmallSimpleVector(const SmallSimpleVector& other, const Allocator& alloc) : Base(alloc) {
+        Reserve(other.size_);
+        UninitializedCopy(data_.GetAllocator(), other.begin(), other.end(), begin());
+        size_ = other.size_;
+    }
+
+    SmallSimpleVector(SmallSimpleVector&& other) noexcept(kIsTriviallyRelocatable<Type> ||
+                                                          std::is_nothrow_move_constructible_v<Type>)
+        : Base(other.data_.GetAllocator()) {
+        StealFrom(other);
+    }
+
+    ~SmallSimpleVector() {
+        DestroyN(data_.GetAllocator(), begin(), size_);
+    }
+
+    SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+        if (this != &rhs) {
+            this->CopyAssign(rhs);
+        }
+        return *this;
+    }
+
+    // Не бросает, если элементы переносятся без исключений, а буфер кучи забирается без
+    // выделения: при неравных нераспространяемых аллокаторах элементы переносятся в свой буфер
+    SmallSimpleVector& operator=(SmallSimpleVector&& other) noexcept(
+        (kIsTriviallyRelocatable<Type> || std::is_nothrow_move_constructible_v<Type>) &&
+        (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
+        if (this != &other) {
+            Clear();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                    ReleaseStorage();
+                    data_.GetAllocator() = std::move(other.data_.GetAllocator());
+                }
+            }
+            StealFrom(other);
+        }
+        return *this;
+    }
+
+    // Элементы лежат во встроенном буфере, куча не используется
+    bool IsSmall() const noexcept {
+        return !data_;
+    }
+
+    void swap(SmallSimpleVector& other) {
+        SmallSimpleVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    // Уменьшает ёмкость до max(new_capacity, GetSize()); ёмкость никогда не растёт.
+    // Если элементы помещаются во встроенный буфер, память кучи освобождается
+    void ShrinkTo(size_t new_capacity) {
+        new_capacity = std::max(new_capacity, size_);
+        if (IsSmall() || new_capacity >= GetCapacity()) {
+            return;
+        }
+        if (new_capacity <= N) {
+            UninitializedRelocate(data_.GetAllocator(), data_.Get(), size_, InlineData());
+            data_ = Storage(data_.GetAllocator());
+            return;
+        }
+        new_capacity = this->RoundCapacity(new_capacity);
+        if (new_capacity < GetCapacity()) {
+            this->ReallocateAndMoveData(new_capacity);
+        }
+    }
+
+private:
+    using Base::size_;
+    using Base::data_;
+    alignas(Type) unsigned char inline_storage_[N * sizeof(Type)];
+
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_storage_);
+    }
+
+    const Type* InlineData() const noexcept {
+        return reinterpret_cast<const Type*>(inline_storage_);
+    }
+
+    Type* BufferData() noexcept {
+        return data_ ? data_.Get() : InlineData();
+    }
+
+    const Type* BufferData() const noexcept {
+        return data_ ? data_.Get() : InlineData();
+    }
+
+    size_t BufferCapacity() const noexcept {
+        return data_ ? data_.GetCapacity() : N;
+    }
+
+    // Возвращает память кучи аллокатору; вектор должен быть пуст
+    void ReleaseStorage() noexcept {
+        assert(size_ == 0);
+        data_ = Storage(data_.GetAllocator());
+    }
+
+    // Забирает элементы other, который остаётся пустым. Вектор должен быть пуст.
+    // Буфер кучи забирается целиком, если это позволяют аллокаторы, иначе элементы переносятся
+    void StealFrom(SmallSimpleVector& other) {
+        assert(size_ == 0);
+        if (!other.IsSmall() && data_.GetAllocator() == other.data_.GetAllocator()) {
+            data_ = std::move(other.data_);
+        } else {
+            Reserve(other.size_);
+            UninitializedRelocate(data_.GetAllocator(), other.begin(), other.size_, begin());
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+};
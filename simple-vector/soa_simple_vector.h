@@ -0,0 +1,346 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "relocation.h"
+#include "simd.h"
+
+// Непрерывный участок одной колонки SoASimpleVector. Не владеет памятью и становится
+// недействительным при реаллокации вектора
+template <typename Type>
+class SoAColumn {
+public:
+    using Iterator = Type*;
+
+    SoAColumn() noexcept = default;
+
+    SoAColumn(Type* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    Iterator begin() const noexcept {
+        return data_;
+    }
+
+    Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Вектор записей из полей Fields..., хранящий каждое поле в отдельном непрерывном буфере
+// (structure of arrays). Цикл, читающий одно поле, использует каждую кэш-линию целиком,
+// а колонку можно обработать SIMD-ядром. Все колонки растут вместе по GrowthPolicy, которой
+// передаётся размер всей записи. Поля должны перемещаться без исключений: тогда перенос
+// колонок при росте не может оставить их разной длины.
+template <typename GrowthPolicy, typename... Fields>
+class BasicSoASimpleVector {
+    static_assert(sizeof...(Fields) != 0, "SoASimpleVector needs at least one field");
+    static_assert((std::is_nothrow_move_constructible_v<Fields> && ...),
+                  "SoASimpleVector requires nothrow move constructible fields");
+
+    using Columns = std::tuple<ArrayPtr<Fields>...>;
+
+    static constexpr size_t kColumnCount = sizeof...(Fields);
+    static constexpr size_t kRowSize = (sizeof(Fields) + ...);
+
+public:
+    using Value = std::tuple<Fields...>;
+    using Reference = std::tuple<Fields&...>;
+    using ConstReference = std::tuple<const Fields&...>;
+
+    template <size_t Index>
+    using FieldType = std::tuple_element_t<Index, Value>;
+
+    BasicSoASimpleVector() noexcept = default;
+
+    explicit BasicSoASimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    BasicSoASimpleVector(const BasicSoASimpleVector& other) : columns_(AllocateColumns(other.size_)) {
+        FillColumns(
+            columns_,
+            [&other](auto& column, auto index) {
+                const auto& source = std::get<decltype(index)::value>(other.columns_);
+                UninitializedCopy(column.GetAllocator(), source.Get(), source.Get() + other.size_, column.Get());
+            },
+            [&other](auto& column) {
+                DestroyN(column.GetAllocator(), column.Get(), other.size_);
+            });
+        size_ = other.size_;
+    }
+
+    BasicSoASimpleVector(BasicSoASimpleVector&& other) noexcept
+        : columns_(std::move(other.columns_)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    BasicSoASimpleVector& operator=(const BasicSoASimpleVector& rhs) {
+        if (this != &rhs) {
+            BasicSoASimpleVector copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    BasicSoASimpleVector& operator=(BasicSoASimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BasicSoASimpleVector moved(std::move(rhs));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~BasicSoASimpleVector() {
+        DestroyRows(columns_, 0, size_);
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return std::get<0>(columns_).GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Запись как кортеж ссылок на её поля
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt<Reference>(*this, index, std::index_sequence_for<Fields...>{});
+    }
+
+    ConstReference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt<ConstReference>(*this, index, std::index_sequence_for<Fields...>{});
+    }
+
+    Reference At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    ConstReference At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    // Колонка поля Index: size элементов подряд
+    template <size_t Index>
+    SoAColumn<FieldType<Index>> Column() noexcept {
+        return {std::get<Index>(columns_).Get(), size_};
+    }
+
+    template <size_t Index>
+    SoAColumn<const FieldType<Index>> Column() const noexcept {
+        return {std::get<Index>(columns_).Get(), size_};
+    }
+
+    template <size_t Index>
+    FieldType<Index>* Data() noexcept {
+        return std::get<Index>(columns_).Get();
+    }
+
+    template <size_t Index>
+    const FieldType<Index>* Data() const noexcept {
+        return std::get<Index>(columns_).Get();
+    }
+
+    void PushBack(const Value& value) {
+        std::apply(
+            [this](const Fields&... fields) {
+                EmplaceBack(fields...);
+            },
+            value);
+    }
+
+    void PushBack(Value&& value) {
+        std::apply(
+            [this](Fields&... fields) {
+                EmplaceBack(std::move(fields)...);
+            },
+            value);
+    }
+
+    // По одному аргументу на поле. Новая запись создаётся до переноса старых, поэтому
+    // аргументы могут ссылаться на элементы этого же вектора
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == kColumnCount, "EmplaceBack expects one argument per field");
+        auto arguments = std::forward_as_tuple(std::forward<Args>(args)...);
+        auto construct = [this, &arguments](auto& column, auto index) {
+            ConstructAt(column.GetAllocator(), column.Get() + size_,
+                        std::get<decltype(index)::value>(std::move(arguments)));
+        };
+        auto rollback = [this](auto& column) {
+            DestroyAt(column.GetAllocator(), column.Get() + size_);
+        };
+        if (size_ == GetCapacity()) {
+            Columns new_columns = AllocateColumns(GrowCapacity(size_ + 1));
+            FillColumns(new_columns, construct, rollback);
+            RelocateTo(std::move(new_columns));
+        } else {
+            FillColumns(columns_, construct, rollback);
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyRows(columns_, size_, 1);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyRows(columns_, new_size, size_ - new_size);
+            size_ = new_size;
+            return;
+        }
+        if (new_size > GetCapacity()) {
+            RelocateTo(AllocateColumns(GrowCapacity(new_size)));
+        }
+        const size_t count = new_size - size_;
+        FillColumns(
+            columns_,
+            [this, count](auto& column, auto) {
+                UninitializedValueConstructN(column.GetAllocator(), column.Get() + size_, count);
+            },
+            [this, count](auto& column) {
+                DestroyN(column.GetAllocator(), column.Get() + size_, count);
+            });
+        size_ = new_size;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            RelocateTo(AllocateColumns(new_capacity));
+        }
+    }
+
+    void ShrinkToFit() {
+        if (size_ < GetCapacity()) {
+            RelocateTo(AllocateColumns(size_));
+        }
+    }
+
+    void Clear() noexcept {
+        DestroyRows(columns_, 0, size_);
+        size_ = 0;
+    }
+
+    void swap(BasicSoASimpleVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    Columns columns_;
+    size_t size_ = 0;
+
+    size_t GrowCapacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(GetCapacity(), required, kRowSize);
+    }
+
+    static Columns AllocateColumns(size_t capacity) {
+        if (capacity > std::numeric_limits<size_t>::max() / kRowSize) {
+            throw std::length_error("SoASimpleVector is too large");
+        }
+        return Columns(ArrayPtr<Fields>(capacity)...);
+    }
+
+    // Вызывает fill(column, integral_constant<Index>) для каждой колонки по порядку. Если вызов
+    // бросил исключение, для уже заполненных колонок вызывается rollback(column)
+    template <typename Fill, typename Rollback>
+    static void FillColumns(Columns& columns, Fill fill, Rollback rollback) {
+        FillColumnsFrom<0>(columns, fill, rollback);
+    }
+
+    template <size_t Index, typename Fill, typename Rollback>
+    static void FillColumnsFrom(Columns& columns, Fill& fill, Rollback& rollback) {
+        if constexpr (Index < kColumnCount) {
+            fill(std::get<Index>(columns), std::integral_constant<size_t, Index>{});
+            try {
+                FillColumnsFrom<Index + 1>(columns, fill, rollback);
+            } catch (...) {
+                rollback(std::get<Index>(columns));
+                throw;
+            }
+        }
+    }
+
+    static void DestroyRows(Columns& columns, size_t first, size_t count) noexcept {
+        std::apply(
+            [first, count](auto&... column) {
+                (DestroyN(column.GetAllocator(), column.Get() + first, count), ...);
+            },
+            columns);
+    }
+
+    // Переносит записи в новые колонки и делает их текущими; не бросает исключений
+    void RelocateTo(Columns new_columns) noexcept {
+        RelocateColumns(new_columns, std::index_sequence_for<Fields...>{});
+        columns_.swap(new_columns);
+    }
+
+    template <size_t... Indices>
+    void RelocateColumns(Columns& new_columns, std::index_sequence<Indices...>) noexcept {
+        (UninitializedRelocate(std::get<Indices>(columns_).GetAllocator(), std::get<Indices>(columns_).Get(), size_,
+                               std::get<Indices>(new_columns).Get()),
+         ...);
+    }
+
+    template <typename Row, typename Self, size_t... Indices>
+    static Row RowAt(Self& self, size_t index, std::index_sequence<Indices...>) noexcept {
+        return Row(std::get<Indices>(self.columns_)[index]...);
+    }
+
+    template <size_t... Indices>
+    bool EqualColumns(const BasicSoASimpleVector& other, std::index_sequence<Indices...>) const {
+        return (RangesEqual(Data<Indices>(), size_, other.template Data<Indices>(), other.size_) && ...);
+    }
+
+    friend bool operator==(const BasicSoASimpleVector& lhs, const BasicSoASimpleVector& rhs) {
+        return lhs.size_ == rhs.size_ && lhs.EqualColumns(rhs, std::index_sequence_for<Fields...>{});
+    }
+
+    friend bool operator!=(const BasicSoASimpleVector& lhs, const BasicSoASimpleVector& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template <typename... Fields>
+using SoASimpleVector = BasicSoASimpleVector<DoublingGrowth, Fields...>;
@@ -0,0 +1,433 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "constexpr_support.h"
+
+namespace static_vector_detail {
+
+// Создаёт значение из аргументов; агрегаты без подходящего конструктора инициализируются списком
+template <typename Type, typename... Args>
+constexpr Type MakeValue(Args&&... args) {
+    if constexpr (std::is_constructible_v<Type, Args&&...>) {
+        return Type(std::forward<Args>(args)...);
+    } else {
+        return Type{std::forward<Args>(args)...};
+    }
+}
+
+// Хранилище тривиальных типов — обычный массив: все операции над ним допустимы в constexpr,
+// а разрушение вектора тривиально. Где язык позволяет (C++20), массив не обнуляется
+// и копируются только первые size_ элементов; при вычислении на этапе компиляции хвост
+// обнуляется, потому что результат константного выражения не может быть неинициализированным.
+// В C++17 constexpr-конструктор обязан инициализировать все члены, и массив копируется целиком
+template <typename Type, size_t Capacity, bool = std::is_trivial_v<Type>>
+class Storage {
+protected:
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR_TRIVIAL_INIT
+    constexpr Storage() noexcept {
+        if (std::is_constant_evaluated()) {
+            FillTail();
+        }
+    }
+
+    constexpr Storage(const Storage& other) noexcept : size_(other.size_) {
+        CopyElements(other);
+        if (std::is_constant_evaluated()) {
+            FillTail();
+        }
+    }
+
+    constexpr Storage& operator=(const Storage& rhs) noexcept {
+        // Хвост при вычислении на этапе компиляции уже обнулён конструктором
+        size_ = rhs.size_;
+        CopyElements(rhs);
+        return *this;
+    }
+#endif
+
+    constexpr Type* Data() noexcept {
+        return data_;
+    }
+
+    constexpr const Type* Data() const noexcept {
+        return data_;
+    }
+
+    template <typename... Args>
+    constexpr void Construct(size_t index, Args&&... args) {
+        data_[index] = MakeValue<Type>(std::forward<Args>(args)...);
+    }
+
+    constexpr void Destroy(size_t /*index*/) noexcept {}
+
+    size_t size_ = 0;
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR_TRIVIAL_INIT
+    Type data_[Capacity != 0 ? Capacity : 1];
+
+private:
+    constexpr void CopyElements(const Storage& other) noexcept {
+        for (size_t i = 0; i < other.size_; ++i) {
+            data_[i] = other.data_[i];
+        }
+    }
+
+    constexpr void FillTail() noexcept {
+        for (size_t i = size_; i < (Capacity != 0 ? Capacity : 1); ++i) {
+            data_[i] = Type();
+        }
+    }
+#else
+    Type data_[Capacity != 0 ? Capacity : 1] = {};
+#endif
+};
+
+// Остальные типы живут в сырой памяти и создаются по месту
+template <typename Type, size_t Capacity>
+class Storage<Type, Capacity, false> {
+protected:
+    Storage() noexcept = default;
+
+    Storage(const Storage& other) {
+        for (; size_ < other.size_; ++size_) {
+            Construct(size_, other.Data()[size_]);
+        }
+    }
+
+    Storage(Storage&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        for (; size_ < other.size_; ++size_) {
+            Construct(size_, std::move(other.Data()[size_]));
+        }
+    }
+
+    Storage& operator=(const Storage& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.Data(), rhs.size_, [](const Type& value) -> const Type& {
+                return value;
+            });
+        }
+        return *this;
+    }
+
+    Storage& operator=(Storage&& rhs) noexcept(std::is_nothrow_move_assignable_v<Type> &&
+                                               std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            Assign(rhs.Data(), rhs.size_, [](Type& value) -> Type&& {
+                return std::move(value);
+            });
+        }
+        return *this;
+    }
+
+    ~Storage() {
+        while (size_ != 0) {
+            Destroy(--size_);
+        }
+    }
+
+    Type* Data() noexcept {
+        return std::launder(reinterpret_cast<Type*>(bytes_));
+    }
+
+    const Type* Data() const noexcept {
+        return std::launder(reinterpret_cast<const Type*>(bytes_));
+    }
+
+    template <typename... Args>
+    void Construct(size_t index, Args&&... args) {
+        new (bytes_ + index * sizeof(Type)) Type(MakeValue<Type>(std::forward<Args>(args)...));
+    }
+
+    void Destroy(size_t index) noexcept {
+        Data()[index].~Type();
+    }
+
+    size_t size_ = 0;
+
+private:
+    alignas(Type) unsigned char bytes_[sizeof(Type) * (Capacity != 0 ? Capacity : 1)];
+
+    // Общий префикс присваивается, недостающее создаётся, лишнее разрушается
+    template <typename Source, typename Forward>
+    void Assign(Source* source, size_t size, Forward forward) {
+        size_t common_size = size_ < size ? size_ : size;
+        for (size_t i = 0; i < common_size; ++i) {
+            Data()[i] = forward(source[i]);
+        }
+        for (; size_ < size; ++size_) {
+            Construct(size_, forward(source[size_]));
+        }
+        while (size_ > size) {
+            Destroy(--size_);
+        }
+    }
+};
+
+}  // namespace static_vector_detail
+
+// Вектор с ёмкостью Capacity, заданной при компиляции. Элементы хранятся внутри объекта,
+// память из кучи не выделяется никогда; попытка превысить ёмкость бросает std::length_error.
+// Для тривиальных типов все операции constexpr и годятся для построения таблиц при компиляции.
+template <typename Type, size_t Capacity>
+class StaticSimpleVector : private static_vector_detail::Storage<Type, Capacity> {
+    using Base = static_vector_detail::Storage<Type, Capacity>;
+    using Base::Construct;
+    using Base::Data;
+    using Base::Destroy;
+    using Base::size_;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    static constexpr size_t kCapacity = Capacity;
+
+    constexpr StaticSimpleVector() noexcept = default;
+
+    constexpr explicit StaticSimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    constexpr StaticSimpleVector(size_t size, const Type& value) {
+        Resize(size, value);
+    }
+
+    constexpr StaticSimpleVector(std::initializer_list<Type> init) {
+        CheckCapacity(init.size());
+        for (const Type& value : init) {
+            Construct(size_++, value);
+        }
+    }
+
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t GetCapacity() noexcept {
+        return Capacity;
+    }
+
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    constexpr const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    constexpr Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return Data()[index];
+    }
+
+    constexpr const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return Data()[index];
+    }
+
+    constexpr Iterator begin() noexcept {
+        return Data();
+    }
+
+    constexpr Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    constexpr ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    constexpr ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+    constexpr void Clear() noexcept {
+        while (size_ != 0) {
+            Destroy(--size_);
+        }
+    }
+
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        while (size_ > new_size) {
+            Destroy(--size_);
+        }
+        for (; size_ < new_size; ++size_) {
+            Construct(size_);
+        }
+    }
+
+    constexpr void Resize(size_t new_size, const Type& value) {
+        CheckCapacity(new_size);
+        while (size_ > new_size) {
+            Destroy(--size_);
+        }
+        for (; size_ < new_size; ++size_) {
+            Construct(size_, value);
+        }
+    }
+
+    constexpr void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    constexpr void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Аргументы не могут ссылаться на перемещаемые элементы: ими никто не двигает
+    template <typename... Args>
+    constexpr Type& EmplaceBack(Args&&... args) {
+        CheckCapacity(size_ + 1);
+        Construct(size_, std::forward<Args>(args)...);
+        return Data()[size_++];
+    }
+
+    constexpr Iterator Insert(ConstIterator position, const Type& value) {
+        return Emplace(position, value);
+    }
+
+    constexpr Iterator Insert(ConstIterator position, Type&& value) {
+        return Emplace(position, std::move(value));
+    }
+
+    // Вставляемое значение сначала создаётся во временном объекте, поэтому аргументы могут
+    // ссылаться на элементы этого же вектора
+    template <typename... Args>
+    constexpr Iterator Emplace(ConstIterator position, Args&&... args) {
+        assert(cbegin() <= position && position <= cend());
+        const size_t offset = position - cbegin();
+        CheckCapacity(size_ + 1);
+        Type temp = static_vector_detail::MakeValue<Type>(std::forward<Args>(args)...);
+        if (offset == size_) {
+            Construct(size_, std::move(temp));
+        } else {
+            Type* data = Data();
+            Construct(size_, std::move(data[size_ - 1]));
+            for (size_t i = size_ - 1; i > offset; --i) {
+                data[i] = std::move(data[i - 1]);
+            }
+            data[offset] = std::move(temp);
+        }
+        ++size_;
+        return begin() + offset;
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(size_ != 0);
+        Destroy(--size_);
+    }
+
+    constexpr Iterator Erase(ConstIterator position) {
+        assert(cbegin() <= position && position < cend());
+        return Erase(position, position + 1);
+    }
+
+    constexpr Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t offset = first - cbegin();
+        const size_t count = last - first;
+        Type* data = Data();
+        for (size_t i = offset; i + count < size_; ++i) {
+            data[i] = std::move(data[i + count]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Destroy(--size_);
+        }
+        return begin() + offset;
+    }
+
+    constexpr void swap(StaticSimpleVector& other) {
+        StaticSimpleVector& shorter = size_ < other.size_ ? *this : other;
+        StaticSimpleVector& longer = size_ < other.size_ ? other : *this;
+        for (size_t i = 0; i < shorter.size_; ++i) {
+            Type temp = std::move(shorter.Data()[i]);
+            shorter.Data()[i] = std::move(longer.Data()[i]);
+            longer.Data()[i] = std::move(temp);
+        }
+        const size_t common_size = shorter.size_;
+        for (size_t i = common_size; i < longer.size_; ++i) {
+            shorter.Construct(shorter.size_++, std::move(longer.Data()[i]));
+        }
+        while (longer.size_ > common_size) {
+            longer.Destroy(--longer.size_);
+        }
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t required) {
+        if (required > Capacity) {
+            throw std::length_error("StaticSimpleVector capacity exceeded");
+        }
+    }
+};
+
+template <typename Type, size_t Capacity>
+constexpr bool operator==(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.GetSize(); ++i) {
+        if (!(lhs[i] == rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator!=(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator<(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    for (size_t i = 0; i < lhs.GetSize() && i < rhs.GetSize(); ++i) {
+        if (lhs[i] < rhs[i]) {
+            return true;
+        }
+        if (rhs[i] < lhs[i]) {
+            return false;
+        }
+    }
+    return lhs.GetSize() < rhs.GetSize();
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator<=(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator>(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t Capacity>
+constexpr bool operator>=(const StaticSimpleVector<Type, Capacity>& lhs, const StaticSimpleVector<Type, Capacity>& rhs) {
+    return !(lhs < rhs);
+}
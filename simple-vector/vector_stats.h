@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "constexpr_support.h"
+
+// Счётчики реаллокаций и сдвигов элементов. Собираются, только если перед подключением
+// simple_vector.h определён макрос SIMPLE_VECTOR_STATS; иначе хуки пустые и ничего не стоят.
+//
+// Сводные значения доступны через GetVectorStats(), а каждое событие дополнительно
+// передаётся в callback, установленный SetVectorStatsCallback: по адресу вектора и
+// стеку вызова можно найти места, которым не хватает Reserve.
+
+enum class VectorEventKind {
+    kReallocate,  // выделен новый буфер, живые элементы перенесены в него
+    kShift,       // элементы сдвинуты внутри буфера при Insert/Erase
+};
+
+struct VectorEvent {
+    VectorEventKind kind;
+    const void* vector;
+    size_t element_size;
+    size_t old_capacity;
+    size_t new_capacity;
+    // Размер вектора по завершении операции
+    size_t size;
+    // Число перенесённых (kReallocate) или сдвинутых (kShift) элементов
+    size_t elements;
+};
+
+struct VectorStatsSnapshot {
+    uint64_t reallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t elements_relocated = 0;
+    uint64_t elements_shifted = 0;
+    // Наибольшее наблюдавшееся отношение ёмкости к размеру
+    double peak_capacity_ratio = 0.0;
+};
+
+// Хуки вызываются посреди операций вектора, в том числе из noexcept-методов, поэтому
+// callback не может бросать исключений: это закреплено в его типе
+using VectorStatsCallback = void (*)(const VectorEvent& event) noexcept;
+
+namespace vector_stats_detail {
+
+struct Counters {
+    std::atomic<uint64_t> reallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> elements_relocated{0};
+    std::atomic<uint64_t> elements_shifted{0};
+    // Отношение в тысячных, чтобы обойтись целочисленным атомиком
+    std::atomic<uint64_t> peak_capacity_ratio_milli{0};
+    std::atomic<VectorStatsCallback> callback{nullptr};
+};
+
+inline Counters& GetCounters() noexcept {
+    static Counters counters;
+    return counters;
+}
+
+inline void UpdatePeakRatio(Counters& counters, size_t capacity, size_t size) noexcept {
+    if (size == 0) {
+        return;
+    }
+    uint64_t ratio = static_cast<uint64_t>(capacity) * 1000 / size;
+    uint64_t current = counters.peak_capacity_ratio_milli.load(std::memory_order_relaxed);
+    while (ratio > current && !counters.peak_capacity_ratio_milli.compare_exchange_weak(
+                                  current, ratio, std::memory_order_relaxed)) {
+    }
+}
+
+// События, порождённые самим callback (например, если он складывает данные в SimpleVector),
+// не передаются повторно, чтобы не уйти в бесконечную рекурсию
+inline void Notify(Counters& counters, const VectorEvent& event) noexcept {
+    thread_local bool in_callback = false;
+    if (in_callback) {
+        return;
+    }
+    if (VectorStatsCallback callback = counters.callback.load(std::memory_order_acquire)) {
+        in_callback = true;
+        callback(event);
+        in_callback = false;
+    }
+}
+
+}  // namespace vector_stats_detail
+
+inline VectorStatsSnapshot GetVectorStats() {
+    auto& counters = vector_stats_detail::GetCounters();
+    VectorStatsSnapshot snapshot;
+    snapshot.reallocations = counters.reallocations.load(std::memory_order_relaxed);
+    snapshot.bytes_allocated = counters.bytes_allocated.load(std::memory_order_relaxed);
+    snapshot.elements_relocated = counters.elements_relocated.load(std::memory_order_relaxed);
+    snapshot.elements_shifted = counters.elements_shifted.load(std::memory_order_relaxed);
+    snapshot.peak_capacity_ratio = counters.peak_capacity_ratio_milli.load(std::memory_order_relaxed) / 1000.0;
+    return snapshot;
+}
+
+inline void ResetVectorStats() {
+    auto& counters = vector_stats_detail::GetCounters();
+    counters.reallocations.store(0, std::memory_order_relaxed);
+    counters.bytes_allocated.store(0, std::memory_order_relaxed);
+    counters.elements_relocated.store(0, std::memory_order_relaxed);
+    counters.elements_shifted.store(0, std::memory_order_relaxed);
+    counters.peak_capacity_ratio_milli.store(0, std::memory_order_relaxed);
+}
+
+inline void SetVectorStatsCallback(VectorStatsCallback callback) noexcept {
+    vector_stats_detail::GetCounters().callback.store(callback, std::memory_order_release);
+}
+
+// Хуки, которые вызывают контейнеры. Они не бросают исключений, и их можно звать откуда
+// угодно. При вычислении на этапе компиляции события не учитываются
+
+// size — размер вектора по завершении операции, для которой выделен буфер. Пустой вектор
+// считается одним элементом: Reserve(n) на пустом векторе оставляет без дела n мест
+inline SIMPLE_VECTOR_CONSTEXPR void RecordVectorReallocation([[maybe_unused]] const void* vector,
+                                                             [[maybe_unused]] size_t element_size,
+                                                             [[maybe_unused]] size_t old_capacity,
+                                                             [[maybe_unused]] size_t new_capacity,
+                                                             [[maybe_unused]] size_t relocated,
+                                                             [[maybe_unused]] size_t size) noexcept {
+#ifdef SIMPLE_VECTOR_STATS
+    if (IsConstantEvaluated()) {
+        return;
+    }
+    auto& counters = vector_stats_detail::GetCounters();
+    counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes_allocated.fetch_add(static_cast<uint64_t>(new_capacity) * element_size, std::memory_order_relaxed);
+    counters.elements_relocated.fetch_add(relocated, std::memory_order_relaxed);
+    vector_stats_detail::UpdatePeakRatio(counters, new_capacity, size != 0 ? size : 1);
+    vector_stats_detail::Notify(counters, {VectorEventKind::kReallocate, vector, element_size, old_capacity,
+                                           new_capacity, size, relocated});
+#endif
+}
+
+inline SIMPLE_VECTOR_CONSTEXPR void RecordVectorShift([[maybe_unused]] const void* vector,
+                                                      [[maybe_unused]] size_t element_size,
+                                                      [[maybe_unused]] size_t capacity, [[maybe_unused]] size_t size,
+                                                      [[maybe_unused]] size_t shifted) noexcept {
+#ifdef SIMPLE_VECTOR_STATS
+    if (IsConstantEvaluated()) {
+        return;
+    }
+    auto& counters = vector_stats_detail::GetCounters();
+    counters.elements_shifted.fetch_add(shifted, std::memory_order_relaxed);
+    vector_stats_detail::UpdatePeakRatio(counters, capacity, size);
+    vector_stats_detail::Notify(counters, {VectorEventKind::kShift, vector, element_size, capacity, capacity, size,
+                                           shifted});
+#endif
+}
+
+// Размер изменился без реаллокации и сдвига (PopBack, Resize, Clear)
+inline SIMPLE_VECTOR_CONSTEXPR void RecordVectorSize([[maybe_unused]] size_t capacity,
+                                                     [[maybe_unused]] size_t size) noexcept {
+#ifdef SIMPLE_VECTOR_STATS
+    if (IsConstantEvaluated()) {
+        return;
+    }
+    vector_stats_detail::UpdatePeakRatio(vector_stats_detail::GetCounters(), capacity, size);
+#endif
+}